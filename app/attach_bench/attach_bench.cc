@@ -0,0 +1,116 @@
+// EPOS Attach/Detach Benchmark
+// Measures the cost of attaching and detaching probe segments to the address space of the task while a growing
+// number of other segments are attached to it. Attach finds free directory entries in a bitmap and detach finds the
+// chunk in a reverse map, both invalidating only the TLB entries of the affected range, so the cost per operation
+// should stay nearly flat as the number of attached segments grows, instead of growing with the directory scans.
+
+#include <time.h>
+#include <utility/ostream.h>
+#include <syscall/stub_task.h>
+#include <syscall/stub_segment.h>
+#include <syscall/stub_chronometer.h>
+
+using namespace EPOS;
+
+typedef _SYS::MMU MMU;
+
+const unsigned int SEGMENT_SIZE = sizeof(MMU::Page);
+const unsigned int MAX_SEGMENTS = 128;
+const unsigned int PROBES = 16;
+const unsigned int ROUNDS = 10;
+
+OStream cout;
+
+Stub_Segment * segments[MAX_SEGMENTS];
+
+void measure(Stub_Address_Space * as, unsigned int attached);
+
+int main()
+{
+    Stub_Address_Space * as = Stub_Task::self()->address_space();
+
+    cout << "Attach/Detach benchmark: " << ROUNDS << " rounds of " << PROBES << " probes per point, " << SEGMENT_SIZE << " bytes per segment" << endl;
+
+    int status = 0;
+    unsigned int attached = 0;
+    for(unsigned int n = 0; !status && (n <= MAX_SEGMENTS); n = n ? n * 2 : 1) {
+        for( ; attached < n; attached++) {
+            segments[attached] = new Stub_Segment(SEGMENT_SIZE, MMU::Flags::APPD);
+            if(!as->attach(segments[attached])) {
+                cout << "Attach/Detach benchmark: could not attach segment " << attached << "!" << endl;
+                segments[attached]->destroy();
+                delete segments[attached];
+                status = -1;
+                break;
+            }
+        }
+        if(!status)
+            measure(as, attached);
+    }
+
+    // Detaching the first segments after the later ones also exercises lookups that miss the reverse map
+    Stub_Chronometer chrono;
+    chrono.start();
+    for(unsigned int i = 0; i < attached; i++)
+        as->detach(segments[i]);
+    chrono.stop();
+    cout << "detach all " << attached << ": " << chrono.read() << " us" << endl;
+
+    for(unsigned int i = 0; i < attached; i++) {
+        segments[i]->destroy();
+        delete segments[i];
+    }
+
+    return status;
+}
+
+void measure(Stub_Address_Space * as, unsigned int attached)
+{
+    Stub_Segment * probes[PROBES];
+    char * addresses[PROBES];
+    for(unsigned int i = 0; i < PROBES; i++)
+        probes[i] = new Stub_Segment(SEGMENT_SIZE, MMU::Flags::APPD);
+
+    Stub_Chronometer chrono;
+    unsigned long long attach_time = 0;
+    unsigned long long detach_time = 0;
+
+    for(unsigned int r = 0; r < ROUNDS; r++) {
+        chrono.reset();
+        chrono.start();
+        for(unsigned int i = 0; i < PROBES; i++)
+            addresses[i] = as->attach(probes[i]);
+        chrono.stop();
+        attach_time += chrono.read();
+
+        // Touch the probes so the detaches have TLB entries to invalidate
+        for(unsigned int i = 0; i < PROBES; i++) {
+            if(!addresses[i]) {
+                cout << "Attach/Detach benchmark: could not attach probe " << i << "!" << endl;
+                for(unsigned int j = 0; j < PROBES; j++) {
+                    if(addresses[j])
+                        as->detach(probes[j]);
+                    probes[j]->destroy();
+                    delete probes[j];
+                }
+                return;
+            }
+            *reinterpret_cast<volatile unsigned int *>(addresses[i]) = r;
+        }
+
+        chrono.reset();
+        chrono.start();
+        for(unsigned int i = 0; i < PROBES; i++)
+            as->detach(probes[i]);
+        chrono.stop();
+        detach_time += chrono.read();
+    }
+
+    cout << attached << " segments attached: attach=" << attach_time / (ROUNDS * PROBES) << " us, detach="
+         << detach_time / (ROUNDS * PROBES) << " us" << endl;
+
+    for(unsigned int i = 0; i < PROBES; i++) {
+        probes[i]->destroy();
+        delete probes[i];
+    }
+}
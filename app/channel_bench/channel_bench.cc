@@ -0,0 +1,149 @@
+// EPOS Inter-Task Channel Benchmark
+// Two copies of this image must be appended to the loader (see "make channel_bench"); the first one to start becomes
+// the producer and the second one the consumer. Each round streams MESSAGES messages of MESSAGE_SIZE bytes between the
+// two tasks, first with the reader/writer pattern (a Shared_Segment buffer guarded by two semaphores), then through a
+// Stub_SPSC_Channel, both copying and in place. The consumer reports messages/s and bytes/s for each round.
+
+#include <time.h>
+#include <utility/ostream.h>
+#include <utility/string.h>
+#include <syscall/stub_thread.h>
+#include <syscall/stub_semaphore.h>
+#include <syscall/stub_chronometer.h>
+#include <syscall/stub_shared_segment.h>
+#include <syscall/stub_channel.h>
+
+using namespace EPOS;
+
+const int RENDEZVOUS_PORT = 20;
+const int BUFFER_PORT = 21;
+const int CHANNEL_PORT = 22;
+
+const unsigned int SLOTS = 16;
+const unsigned int MESSAGE_SIZE = 64;
+const unsigned int MESSAGES = 10000;
+
+// Stub_Semaphores are plain kernel handles, so the producer publishes them to the consumer by value
+struct Rendezvous {
+    volatile unsigned int peers;
+    volatile unsigned int ready;
+    char empty[sizeof(Stub_Semaphore)];
+    char full[sizeof(Stub_Semaphore)];
+};
+
+OStream cout;
+
+Rendezvous * rendezvous;
+Stub_Semaphore * empty;
+Stub_Semaphore * full;
+char * buffer;
+Stub_SPSC_Channel * channel;
+
+void produce();
+void consume();
+void report(const char * round, _SYS::Microsecond elapsed);
+
+int main()
+{
+    rendezvous = Stub_Shared_Segment::attach(RENDEZVOUS_PORT, sizeof(Rendezvous));
+    buffer = Stub_Shared_Segment::attach(BUFFER_PORT, SLOTS * MESSAGE_SIZE);
+    channel = new Stub_SPSC_Channel(CHANNEL_PORT, SLOTS, MESSAGE_SIZE);
+    if(!rendezvous || !buffer || !channel->valid()) {
+        cout << "Channel benchmark: could not map the shared segments!" << endl;
+        return -1;
+    }
+
+    if(_SYS::CPU::finc(rendezvous->peers) == 0) {
+        empty = new Stub_Semaphore(SLOTS);
+        full = new Stub_Semaphore(0);
+        memcpy(rendezvous->empty, empty, sizeof(Stub_Semaphore));
+        memcpy(rendezvous->full, full, sizeof(Stub_Semaphore));
+        rendezvous->ready = 1;
+        produce();
+    } else {
+        while(!rendezvous->ready)
+            Stub_Thread::yield();
+        empty = reinterpret_cast<Stub_Semaphore *>(rendezvous->empty);
+        full = reinterpret_cast<Stub_Semaphore *>(rendezvous->full);
+        consume();
+    }
+
+    Stub_Shared_Segment::detach(CHANNEL_PORT);
+    Stub_Shared_Segment::detach(BUFFER_PORT);
+    Stub_Shared_Segment::detach(RENDEZVOUS_PORT);
+
+    return 0;
+}
+
+void produce()
+{
+    char message[MESSAGE_SIZE];
+    for(unsigned int i = 0; i < MESSAGE_SIZE; i++)
+        message[i] = 'a' + i % 26;
+
+    cout << "Channel benchmark: producer (" << MESSAGES << " messages of " << MESSAGE_SIZE << " bytes, " << SLOTS << " slots)" << endl;
+
+    // Reader/writer pattern
+    for(unsigned int i = 0; i < MESSAGES; i++) {
+        empty->p();
+        memcpy(&buffer[(i % SLOTS) * MESSAGE_SIZE], message, MESSAGE_SIZE);
+        full->v();
+    }
+
+    // Channel, copying
+    for(unsigned int i = 0; i < MESSAGES; i++)
+        channel->send(message, MESSAGE_SIZE);
+
+    // Channel, in place
+    for(unsigned int i = 0; i < MESSAGES; i++) {
+        void * p = channel->reserve();
+        memcpy(p, message, MESSAGE_SIZE);
+        channel->commit(p, MESSAGE_SIZE);
+    }
+}
+
+void consume()
+{
+    char message[MESSAGE_SIZE];
+    unsigned int bytes = 0;
+    Stub_Chronometer chrono;
+
+    cout << "Channel benchmark: consumer" << endl;
+
+    chrono.start();
+    for(unsigned int i = 0; i < MESSAGES; i++) {
+        full->p();
+        memcpy(message, &buffer[(i % SLOTS) * MESSAGE_SIZE], MESSAGE_SIZE);
+        empty->v();
+    }
+    chrono.stop();
+    report("semaphores + Shared_Segment", chrono.read());
+
+    chrono.reset();
+    chrono.start();
+    for(unsigned int i = 0; i < MESSAGES; i++)
+        bytes += channel->receive(message, MESSAGE_SIZE);
+    chrono.stop();
+    report("SPSC channel (copy)", chrono.read());
+
+    chrono.reset();
+    chrono.start();
+    for(unsigned int i = 0; i < MESSAGES; i++) {
+        unsigned int size;
+        const char * p = static_cast<const char *>(channel->acquire(&size));
+        bytes += p[size - 1]; // touch the payload in place
+        channel->release(const_cast<char *>(p));
+    }
+    chrono.stop();
+    report("SPSC channel (in place)", chrono.read());
+}
+
+void report(const char * round, _SYS::Microsecond elapsed)
+{
+    if(!elapsed)
+        elapsed = 1;
+
+    cout << round << ": " << elapsed << " us, "
+         << static_cast<unsigned long long>(MESSAGES) * 1000000 / elapsed << " messages/s, "
+         << static_cast<unsigned long long>(MESSAGES) * MESSAGE_SIZE * 1000000 / elapsed << " bytes/s" << endl;
+}
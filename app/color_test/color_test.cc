@@ -0,0 +1,196 @@
+// EPOS Cache Coloring Test
+// The boot image carries this application followed by four copies of itself (see "make color_test"). The first
+// instance loads the others in two rounds, each made of a periodic task and a memory-thrashing one. In the first round
+// no task has colors of its own; in the second the periodic task is loaded with half of the L2 cache colors, so the
+// thrasher gets frames of the other half only. Each job of the periodic task walks a working set that fits in that half
+// of the L2, and the task reports the spread of its job execution times and L2 refills for the round. The thrasher
+// runs at LOW priority whenever the periodic task sleeps, so without colors it evicts the working set between jobs.
+
+#include <time.h>
+#include <system.h>
+#include <utility/ostream.h>
+#include <utility/elf.h>
+#include <syscall/stub_thread.h>
+#include <syscall/stub_task.h>
+#include <syscall/stub_alarm.h>
+#include <syscall/stub_chronometer.h>
+#include <syscall/stub_shared_segment.h>
+#include <syscall/stub_pmu.h>
+
+using namespace EPOS;
+
+const int CONTROL_PORT = 23;
+
+const unsigned int COLORS = _SYS::Traits<_SYS::MMU>::colorful ? _SYS::Traits<_SYS::MMU>::COLORS : 1;
+const unsigned int LINE_SIZE = 64;
+const unsigned int WORKING_SET = 128 * 1024;        // more than the L1, less than half of the L2
+const unsigned int THRASH_SET = 1024 * 1024;        // twice the L2
+const unsigned int PASSES = 4;                      // over the working set in each job
+const unsigned int JOBS = 200;
+const unsigned int PERIOD = 10000;                  // us
+const unsigned int IMAGES = 4;
+const Stub_PMU::Channel CHANNEL = 0;
+
+enum Role {
+    PERIODIC,
+    THRASHER
+};
+
+struct Control {
+    volatile unsigned int instances;
+    volatile unsigned int role;         // of the instance being loaded
+    volatile unsigned int round;        // the thrasher of a round quits when it changes
+    volatile unsigned int thrashing;    // round whose thrasher is running
+    volatile unsigned int done;         // round whose periodic task has finished
+};
+
+OStream cout;
+
+Control * control;
+char working_set[WORKING_SET];
+char thrash_set[THRASH_SET];
+
+int controller(char * extras, unsigned int size);
+bool run_round(unsigned int round, unsigned int colors, ELF * periodic_image, ELF * thrasher_image);
+int periodic();
+int thrasher();
+
+int main(int argc, char ** argv)
+{
+    control = Stub_Shared_Segment::attach(CONTROL_PORT, sizeof(Control));
+    if(!control) {
+        cout << "Color test: could not map the control segment!" << endl;
+        return -1;
+    }
+
+    if(_SYS::CPU::finc(control->instances) == 0)
+        return controller(reinterpret_cast<char *>(argv), argc);
+
+    return (control->role == PERIODIC) ? periodic() : thrasher();
+}
+
+int controller(char * extras, unsigned int size)
+{
+    ELF * images[IMAGES];
+    unsigned int n = 0;
+
+    // Extras come in page-aligned records, each made of an index followed by an ELF image (see Image_Index in system/info.h)
+    for(_SYS::Image_Index * index = reinterpret_cast<_SYS::Image_Index *>(extras);
+        (n < IMAGES) && (reinterpret_cast<char *>(index) < extras + size) && index->size;
+        index = reinterpret_cast<_SYS::Image_Index *>(reinterpret_cast<char *>(index) + index->size)) {
+        ELF * elf = reinterpret_cast<ELF *>(reinterpret_cast<char *>(index) + index->file_offset);
+        if(index->segments && elf->valid())
+            images[n++] = elf;
+    }
+    if(n < IMAGES) {
+        cout << "Color test: " << IMAGES << " copies of the application must follow it in the boot image, found " << n << "!" << endl;
+        return -1;
+    }
+    if(COLORS < 2)
+        cout << "Color test: this machine has no cache colors, both rounds will run uncolored" << endl;
+
+    if(!Stub_PMU::config(CHANNEL, _SYS::Traits_Tokens::L2_CACHE_MISSES_CA)) {
+        cout << "Color test: could not configure the PMU!" << endl;
+        return -1;
+    }
+
+    bool ok = run_round(1, 0, images[0], images[1]) && run_round(2, COLORS / 2, images[2], images[3]);
+    control->round = 0;
+    Stub_PMU::stop(CHANNEL);
+
+    return ok ? 0 : -1;
+}
+
+bool run_round(unsigned int round, unsigned int colors, ELF * periodic_image, ELF * thrasher_image)
+{
+    unsigned int heap = _SYS::MMU::align_page(_SYS::Application::HEAP_SIZE);
+
+    control->round = round;
+
+    // Instances only read their role after they start, so the next one is only loaded after the previous one started
+    control->role = PERIODIC;
+    unsigned int instances = control->instances;
+    if(!Stub_Task::load(periodic_image, heap, colors)) {
+        cout << "Color test: could not load the periodic task!" << endl;
+        return false;
+    }
+    while(control->instances == instances)
+        Stub_Thread::yield();
+
+    control->role = THRASHER;
+    instances = control->instances;
+    if(!Stub_Task::load(thrasher_image, heap)) {
+        cout << "Color test: could not load the thrasher!" << endl;
+        return false;
+    }
+    while(control->instances == instances)
+        Stub_Thread::yield();
+
+    while(control->done != round)
+        Stub_Alarm::delay(PERIOD * 10);
+
+    return true;
+}
+
+int periodic()
+{
+    unsigned int round = control->round;
+    Stub_Chronometer chrono;
+
+    while(control->thrashing != round)
+        Stub_Alarm::delay(PERIOD);
+
+    unsigned int sum = 0;
+    for(unsigned int i = 0; i < WORKING_SET; i += LINE_SIZE)
+        sum += working_set[i];
+
+    _SYS::Microsecond min = ~0U;
+    _SYS::Microsecond max = 0;
+    unsigned long long total = 0;
+    unsigned long long squares = 0;
+    unsigned long long refills = 0;
+    for(unsigned int job = 0; job < JOBS; job++) {
+        Stub_Alarm::delay(PERIOD);
+
+        Stub_PMU::Count before = Stub_PMU::read(CHANNEL);
+        chrono.reset();
+        chrono.start();
+        for(unsigned int pass = 0; pass < PASSES; pass++)
+            for(unsigned int i = 0; i < WORKING_SET; i += LINE_SIZE)
+                sum += working_set[i]++;
+        chrono.stop();
+        refills += static_cast<unsigned int>(Stub_PMU::read(CHANNEL) - before);
+
+        _SYS::Microsecond time = chrono.read();
+        if(time < min)
+            min = time;
+        if(time > max)
+            max = time;
+        total += time;
+        squares += static_cast<unsigned long long>(time) * time;
+    }
+
+    unsigned long long mean = total / JOBS;
+    cout << "Round " << round << " (" << ((round == 1) ? "no colors" : "private colors") << "): "
+         << "job time min=" << min << " mean=" << mean << " max=" << max << " us, "
+         << "variance=" << squares / JOBS - mean * mean << " us^2, "
+         << "L2 refills/job=" << refills / JOBS << " (checksum " << sum << ")" << endl;
+
+    control->done = round;
+
+    return 0;
+}
+
+int thrasher()
+{
+    unsigned int round = control->round;
+
+    Stub_Thread::self()->priority(_SYS::Thread::LOW);
+    control->thrashing = round;
+
+    while(control->round == round)
+        for(unsigned int i = 0; i < THRASH_SET; i += LINE_SIZE)
+            thrash_set[i]++;
+
+    return 0;
+}
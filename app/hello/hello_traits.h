@@ -20,6 +20,7 @@ template<> struct Traits<Build>: public Traits_Tokens
     // Default flags
     static const bool enabled = true;
     static const bool monitored = false;
+    static const bool traced = false;
     static const bool debugged = true;
     static const bool hysterically_debugged = false;
 
@@ -35,6 +36,8 @@ template<> struct Traits<Debug>: public Traits<Build>
     static const bool warning = true;
     static const bool info    = false;
     static const bool trace   = true;
+    static const bool buffered = true;          // defer console output to Thread::idle through a lock-free ring
+    static const unsigned int LOG_SIZE = 4096;  // bytes, power of 2
 };
 
 template<> struct Traits<Lists>: public Traits<Build>
@@ -73,6 +76,15 @@ template<> struct Traits<Init>: public Traits<Build>
 {
 };
 
+template<> struct Traits<Tracer>: public Traits<Build>
+{
+    static const bool enabled = false;          // record binary events of the components whose Traits are "traced"
+    static const unsigned int RECORDS = 1024;   // the oldest records are overwritten
+    static const bool irq_profile = false;      // per-interrupt latency and handler time histograms (PMU cycles)
+    static const bool int_off_profile = false;  // longest interrupt-disabled intervals per call site (PMU cycles)
+    static const bool boot_trace = false;       // timestamp SETUP, INIT and each task's first dispatch into System_Info
+};
+
 template<> struct Traits<Framework>: public Traits<Build>
 {
 };
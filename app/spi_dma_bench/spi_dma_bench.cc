@@ -0,0 +1,108 @@
+// EPOS SPI DMA Benchmark
+// Measures the CPU time spent per transferred kilobyte by polled and by DMA-driven SPI transfers, with the PL022 in
+// loop-back mode so no slave is needed. A LOW-priority thread counts while the CPU is otherwise free; its counting
+// rate on an idle system converts counts into idle time, and the CPU time of a round is its elapsed time minus that.
+
+#include <time.h>
+#include <process.h>
+#include <machine/spi.h>
+#include <architecture/mmu.h>
+#include <utility/ostream.h>
+#include <utility/string.h>
+
+using namespace EPOS;
+
+typedef _SYS::MMU::DMA_Buffer DMA_Buffer;
+
+const unsigned int KB = 1024;
+const unsigned int SIZE = 4 * KB;               // bytes per round
+const unsigned int SEGMENTS = 4;                // DMA scatter/gather list length
+const unsigned int BIT_RATE = 1000000;          // bps
+const unsigned int CALIBRATION = 100000;        // us
+
+OStream cout;
+
+volatile unsigned long long spins;
+volatile bool finish;
+
+int spinner();
+void report(const char * round, unsigned long long elapsed, unsigned long long idle_spins, unsigned long long rate);
+
+int main()
+{
+    cout << "SPI DMA benchmark (" << SIZE << " bytes per round at " << BIT_RATE << " bps in loop-back mode)" << endl;
+
+    SPI spi(0, Traits<CPU>::CLOCK, SPI::MOTO0, SPI::MASTER, BIT_RATE, 8);
+    spi.loopback();
+
+    DMA_Buffer * tx = new DMA_Buffer(SIZE);
+    DMA_Buffer * rx = new DMA_Buffer(SIZE);
+    char * out = tx->log_address();
+    char * in = rx->log_address();
+    for(unsigned int i = 0; i < SIZE; i++)
+        out[i] = i;
+
+    Thread * idle = new Thread(Thread::Configuration(Thread::READY, Thread::LOW), &spinner);
+
+    // Calibration: counts per second with nothing else to run
+    TSC_Chronometer chrono;
+    unsigned long long before = spins;
+    chrono.start();
+    Delay calibration(CALIBRATION);
+    chrono.stop();
+    unsigned long long rate = (spins - before) * 1000000 / chrono.read();
+
+    // Polled transfers (the CPU is busy all the time)
+    before = spins;
+    chrono.reset();
+    chrono.start();
+    for(unsigned int i = 0; i < SIZE; i++) {
+        spi.put(out[i]);
+        in[i] = spi.get();
+    }
+    chrono.stop();
+    report("polled", chrono.read(), spins - before, rate);
+
+    // DMA transfers (the CPU is free while the data moves)
+    SPI::Segment list[SEGMENTS];
+    for(unsigned int i = 0; i < SEGMENTS; i++) {
+        list[i].tx = &out[i * SIZE / SEGMENTS];
+        list[i].rx = &in[i * SIZE / SEGMENTS];
+        list[i].size = SIZE / SEGMENTS;
+    }
+    memset(in, 0, SIZE);
+    before = spins;
+    chrono.reset();
+    chrono.start();
+    bool ok = spi.transfer(list, SEGMENTS);
+    spi.wait();
+    chrono.stop();
+    if(!ok || memcmp(in, out, SIZE))
+        cout << "DMA transfer failed!" << endl;
+    report("DMA", chrono.read(), spins - before, rate);
+
+    finish = true;
+    idle->join();
+
+    delete idle;
+    delete rx;
+    delete tx;
+
+    return 0;
+}
+
+int spinner()
+{
+    while(!finish)
+        spins++;
+
+    return 0;
+}
+
+void report(const char * round, unsigned long long elapsed, unsigned long long idle_spins, unsigned long long rate)
+{
+    unsigned long long idle = rate ? idle_spins * 1000000 / rate : 0;
+    unsigned long long busy = (idle < elapsed) ? elapsed - idle : 0;
+
+    cout << round << ": " << elapsed << " us elapsed, " << busy << " us of CPU, " << busy * KB / SIZE << " us of CPU per KB" << endl;
+}
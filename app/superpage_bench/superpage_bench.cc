@@ -0,0 +1,99 @@
+// EPOS Superpage Benchmark
+// Walks a 16 MB data segment, first touching one word per cache line and then one word per page, and reports the
+// runtime and the number of L1 data TLB refills of each walk. Segments backed by contiguous, aligned frames are mapped
+// with 64 KB large pages and attached with 1 MB sections, so the refills of the page walk should drop by two orders of
+// magnitude when compared to a kernel that maps every page on its own.
+
+#include <time.h>
+#include <utility/ostream.h>
+#include <syscall/stub_task.h>
+#include <syscall/stub_segment.h>
+#include <syscall/stub_chronometer.h>
+#include <syscall/stub_pmu.h>
+
+using namespace EPOS;
+
+typedef _SYS::MMU MMU;
+
+const unsigned int SEGMENT_SIZE = 16 * 1024 * 1024;
+const unsigned int LINE_SIZE = 64;
+const unsigned int WALKS = 8;
+const Stub_PMU::Channel CHANNEL = 0;
+
+OStream cout;
+
+volatile unsigned int sink;
+
+unsigned int contiguous(Stub_Address_Space * as, char * base);
+void walk(const char * round, volatile unsigned int * base, unsigned int stride);
+
+int main()
+{
+    Stub_Address_Space * as = Stub_Task::self()->address_space();
+    Stub_Segment * segment = new Stub_Segment(SEGMENT_SIZE, MMU::Flags::APPD);
+    char * base = as->attach(segment);
+    if(!base) {
+        cout << "Superpage benchmark: could not attach the segment!" << endl;
+        return -1;
+    }
+
+    cout << "Superpage benchmark: " << SEGMENT_SIZE / 1024 << " KB at " << reinterpret_cast<void *>(base)
+         << ", shortest physically contiguous run: " << contiguous(as, base) << " KB" << endl;
+
+    if(!Stub_PMU::config(CHANNEL, _SYS::Traits_Tokens::L1D_TLB_MISS_CA)) {
+        cout << "Superpage benchmark: could not configure the PMU!" << endl;
+        return -1;
+    }
+
+    walk("warm up", reinterpret_cast<volatile unsigned int *>(base), LINE_SIZE);
+    walk("line stride", reinterpret_cast<volatile unsigned int *>(base), LINE_SIZE);
+    walk("page stride", reinterpret_cast<volatile unsigned int *>(base), sizeof(MMU::Page));
+
+    Stub_PMU::stop(CHANNEL);
+    as->detach(segment);
+
+    return 0;
+}
+
+// Returns the shortest run of physically contiguous pages in the segment, in KB
+unsigned int contiguous(Stub_Address_Space * as, char * base)
+{
+    unsigned int shortest = SEGMENT_SIZE;
+    unsigned int run = 0;
+    unsigned int expected = as->physical(base);
+    for(unsigned int offset = 0; offset < SEGMENT_SIZE; offset += sizeof(MMU::Page), expected += sizeof(MMU::Page), run += sizeof(MMU::Page))
+        if(as->physical(base + offset) != expected) {
+            if(run < shortest)
+                shortest = run;
+            run = 0;
+            expected = as->physical(base + offset);
+        }
+    if(run < shortest)
+        shortest = run;
+    return shortest / 1024;
+}
+
+void walk(const char * round, volatile unsigned int * base, unsigned int stride)
+{
+    unsigned int step = stride / sizeof(unsigned int);
+    unsigned int words = SEGMENT_SIZE / sizeof(unsigned int);
+    unsigned int sum = 0;
+    Stub_Chronometer chrono;
+
+    Stub_PMU::reset(CHANNEL);
+    chrono.start();
+    for(unsigned int i = 0; i < WALKS; i++)
+        for(unsigned int j = 0; j < words; j += step)
+            sum += base[j];
+    chrono.stop();
+    Stub_PMU::Count refills = Stub_PMU::read(CHANNEL);
+    sink = sum;
+
+    _SYS::Microsecond elapsed = chrono.read();
+    if(!elapsed)
+        elapsed = 1;
+
+    cout << round << ": " << elapsed << " us, " << refills << " TLB refills, "
+         << refills / WALKS << " per walk, "
+         << static_cast<unsigned long long>(WALKS) * (SEGMENT_SIZE / stride) * 1000 / elapsed << " accesses/ms" << endl;
+}
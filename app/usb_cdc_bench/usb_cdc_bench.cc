@@ -0,0 +1,45 @@
+// EPOS USB CDC Packet Throughput Benchmark
+// Measures host-to-device throughput over the USB serial port with the packet-level interface. Keep the host writing
+// to the port (e.g. "cat /dev/zero > /dev/ttyACM0") while the test runs; each received packet is released back to
+// the ring untouched, so the figures reflect the driver and the bus, not the application.
+
+#include <time.h>
+#include <machine/usb.h>
+#include <utility/ostream.h>
+
+using namespace EPOS;
+
+const unsigned int KB = 1024;
+const unsigned int ROUNDS = 10;
+const unsigned int ROUND_SIZE = 256 * KB;       // bytes per round
+
+OStream cout;
+
+int main()
+{
+    cout << "USB CDC packet throughput benchmark (" << ROUNDS << " rounds of " << ROUND_SIZE / KB << " KB)" << endl;
+
+    USB usb;
+    TSC_Chronometer chrono;
+
+    for(unsigned int i = 0; i < ROUNDS; i++) {
+        unsigned int bytes = 0;
+        unsigned int packets = 0;
+
+        chrono.reset();
+        chrono.start();
+        while(bytes < ROUND_SIZE) {
+            USB::Buffer * buf = usb.receive();
+            bytes += buf->size();
+            packets++;
+            usb.release(buf);
+        }
+        chrono.stop();
+
+        unsigned long long elapsed = chrono.read();
+        cout << "round " << i << ": " << bytes << " bytes in " << packets << " packets, " << elapsed << " us, "
+             << (elapsed ? static_cast<unsigned long long>(bytes) * 1000000 / elapsed / KB : 0) << " KB/s" << endl;
+    }
+
+    return 0;
+}
@@ -338,7 +338,12 @@ public:
     static void dacr(Reg r) {  ASM ("mcr p15, 0, %0, c3, c0, 0" : : "p"(r) :); }
 
     static void flush_tlb() {      ASM("mcr p15, 0, %0, c8, c7, 0" : : "r" (0)); } // TLBIALL - invalidate entire unifed TLB
-    static void flush_tlb(Reg r) { ASM("mcr p15, 0, %0, c8, c7, 0" : : "r" (r)); }
+    static void flush_tlb(Reg r) { // TLBIMVAA(IS) - invalidate unified TLB entries by MVA, all ASIDs (on all cores if multicore)
+        if(multicore)
+            ASM("mcr p15, 0, %0, c8, c3, 3" : : "r" (r));
+        else
+            ASM("mcr p15, 0, %0, c8, c7, 3" : : "r" (r));
+    }
 
     static void flush_branch_predictors() { ASM("mcr p15, 0, %0, c7, c5, 6" : : "r" (0)); }
 
@@ -491,8 +496,24 @@ public:
 
     static Hertz bus_clock() { return _bus_clock; }
 
-    using Base::int_enable;
-    using Base::int_disable;
+    // With Traits<Tracer>::int_off_profile, the intervals between disabling interrupts (from an enabled state) and
+    // re-enabling them are accounted to the disabling call site by Int_Off_Profiler (include/tracer.h)
+    static void int_enable() {
+        if(Traits<Tracer>::int_off_profile && Base::int_disabled())
+            int_off_end();
+        Base::int_enable();
+    }
+    static void int_disable() {
+        bool enabled = Traits<Tracer>::int_off_profile && Base::int_enabled();
+        Base::int_disable();
+        if(enabled)
+            int_off_begin();
+    }
+    // Exception entries and context loads end such intervals by restoring a saved status register, so they discard them
+    static void int_off_discard() {
+        if(Traits<Tracer>::int_off_profile)
+            int_off_clear();
+    }
     using Base::int_enabled;
     using Base::int_disabled;
 
@@ -565,6 +586,11 @@ private:
     }
     static void init_stack_helper(Log_Addr sp) {}
 
+    // Out of line, so __builtin_return_address() identifies the site that disabled the interrupts
+    static void int_off_begin() __attribute__ ((noinline));
+    static void int_off_end() __attribute__ ((noinline));
+    static void int_off_clear();
+
     static void init();
 
 private:
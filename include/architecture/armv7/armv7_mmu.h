@@ -23,6 +23,11 @@ private:
     static const unsigned int PHY_MEM = Memory_Map::PHY_MEM;
     static const unsigned int SYS = Memory_Map::SYS;
 
+public:
+    static const unsigned int LARGE_PAGES = 16;                                  // small pages per large page
+    static const unsigned int LARGE_PAGE_SIZE = LARGE_PAGES * PAGE_SIZE;         // 64 KB
+    static const unsigned int SECTION_SIZE = 1 << DIRECTORY_SHIFT;               // 1 MB, what a directory entry maps
+
 public:
     // Page Flags
     class Page_Flags
@@ -62,6 +67,14 @@ public:
             PT_MASK = (1 << 12) - 1
         };
 
+        // Large Page (64 KB) entry flags; the other bits are those of a small page, except for TEX, which moves to [14:12]
+        enum {
+            LPTE = 1 << 0,  // sets entry as Large Page
+            LXN  = 1 << 15, // not executable
+            TEX  = (TEX2 | TEX1 | TEX0),
+            LP_MASK = (1 << 16) - 1
+        };
+
         // Short-descriptor format | Page Directory entry flags
         enum {
             PDE  = 1 << 0,         // Set descriptor as Page Directory entry
@@ -70,6 +83,14 @@ public:
             PD_MASK = (1 << 10) -1
         };
 
+        // Section (1 MB) Page Directory entry flags; AP, TEX, S and nG are those of a small page shifted left by 6
+        enum {
+            SECTION = 1 << 1,      // Set descriptor as Section
+            SXN     = 1 << 4,      // not executable
+            SNS     = 1 << 19,     // NonSecure Memory Region
+            SECTION_MASK = (1 << 20) - 1
+        };
+
     public:
         Page_Flags() {}
         Page_Flags(unsigned int f) : _flags(f) {}
@@ -99,8 +120,11 @@ public:
         PT_Entry & operator[](unsigned int i) { return _entry[i]; }
         _Page_Table & log() { return *static_cast<_Page_Table *>(phy2log(this)); }
 
+        // Tries frames aligned like the entries first (see reserve()), then any contiguous run and finally scattered frames
         void map(int from, int to, Page_Flags flags, Color color) {
-            Phy_Addr * addr = alloc(to - from, color);
+            Phy_Addr addr = reserve(from, to, color);
+            if(!addr)
+                addr = alloc(to - from, color);
             if(addr)
                 remap(addr, from, to, flags);
             else
@@ -111,26 +135,55 @@ public:
         }
 
         void map_contiguous(int from, int to, Page_Flags flags, Color color) {
-            remap(alloc(to - from, color), from, to, flags);
+            Phy_Addr addr = reserve(from, to, color);
+            remap(addr ? addr : alloc(to - from, color), from, to, flags);
         }
 
+        // Uses 64 KB large pages wherever both the entries and the frames are aligned, so a contiguous mapping takes
+        // 16 times fewer TLB entries
         void remap(Phy_Addr addr, int from, int to, Page_Flags flags) {
             addr = align_page(addr);
-            for( ; from < to; from++) {
-                Log_Addr * pte = phy2log(&_entry[from]);
-                *pte = phy2pte(addr, flags);
-                addr += sizeof(Page);
+            split(from);
+            split(to - 1);
+            while(from < to) {
+                if(!(from % LARGE_PAGES) && (to - from >= static_cast<int>(LARGE_PAGES)) && !(addr & (LARGE_PAGE_SIZE - 1))) {
+                    PT_Entry lpte = phy2lpte(addr, flags);
+                    for(unsigned int i = 0; i < LARGE_PAGES; i++, from++) {
+                        Log_Addr * pte = phy2log(&_entry[from]);
+                        *pte = lpte;
+                    }
+                    addr += LARGE_PAGE_SIZE;
+                } else {
+                    Log_Addr * pte = phy2log(&_entry[from]);
+                    *pte = phy2pte(addr, flags);
+                    addr += sizeof(Page);
+                    from++;
+                }
             }
         }
 
         void unmap(int from, int to) {
+            split(from);
+            split(to - 1);
             for( ; from < to; from++) {
-                free(_entry[from]);
+                free(pte2phy(_entry[from], from));
                 Log_Addr * pte = phy2log(&_entry[from]);
                 *pte = 0;
             }
         }
 
+        // Rewrites the large page holding entry i, if any, as small pages mapping the same frames, so that part of it
+        // can be remapped (all entries of a large page must be identical)
+        void split(int i) {
+            PT_Entry * pt = phy2log(_entry);
+            if((i < 0) || (i >= static_cast<int>(ENTRIES)) || !large(pt[i]))
+                return;
+            i -= i % LARGE_PAGES;
+            PT_Entry lpte = pt[i];
+            for(unsigned int j = 0; j < LARGE_PAGES; j++)
+                pt[i + j] = lpte2pte(lpte, j);
+        }
+
         friend OStream & operator<<(OStream & os, _Page_Table & pt) {
             os << "{\n";
             int brk = 0;
@@ -213,31 +266,49 @@ public:
     public:
         Chunk() {}
 
+        // Colored chunks get their frames one at a time (contiguous frames span all colors)
         Chunk(unsigned int bytes, Flags flags, Color color = WHITE)
-        : _from(0), _to(pages(bytes)), _pts(page_tables(_to - _from)), _flags(Page_Flags(flags)), _pt(calloc(_pts, WHITE)) {
-            if(!((_flags & Page_Flags::CWT) || (_flags & Page_Flags::CD))) // CT == Strongly Ordered == C/B/TEX bits are 0
-                _pt->map_contiguous(_from, _to, _flags, color);
-            else
+        : _from(0), _to(pages(bytes)), _pts(page_tables(_to - _from)), _flags(Page_Flags(flags)), _color(color), _pt(calloc(_pts, WHITE)), _shared(0), _reserved(0) {
+            if(!((_flags & Page_Flags::CWT) || (_flags & Page_Flags::CD))) { // CT == Strongly Ordered == C/B/TEX bits are 0
+                _color = WHITE;
+                _pt->map_contiguous(_from, _to, _flags, WHITE);
+            } else
+                _pt->map(_from, _to, _flags, _color);
+        }
+
+        // Only the page tables are allocated; pages are later given frames with share() or populate(), which take them
+        // from a contiguous reservation whenever one could be made, so the chunk can still end up with large pages
+        Chunk(unsigned int bytes, Flags flags, Color color, bool populated)
+        : _from(0), _to(pages(bytes)), _pts(page_tables(_to - _from)), _flags(Page_Flags(flags)), _color(color), _pt(calloc(_pts, WHITE)), _shared(0), _reserved(0) {
+            if(populated)
                 _pt->map(_from, _to, _flags, color);
+            else
+                _reserved = reserve(_from, _to, color);
         }
 
         Chunk(Phy_Addr phy_addr, unsigned int bytes, Flags flags)
-        : _from(0), _to(pages(bytes)), _pts(page_tables(_to - _from)), _flags(Page_Flags(flags)), _pt(calloc(_pts, WHITE)) {
+        : _from(0), _to(pages(bytes)), _pts(page_tables(_to - _from)), _flags(Page_Flags(flags)), _color(WHITE), _pt(calloc(_pts, WHITE)), _shared(0), _reserved(0) {
             _pt->remap(phy_addr, _from, _to, flags);
         }
 
         Chunk(Phy_Addr pt, unsigned int from, unsigned int to, Flags flags)
-        : _from(from), _to(to), _pts(page_tables(_to - _from)), _flags(flags), _pt(pt) {}
+        : _from(from), _to(to), _pts(page_tables(_to - _from)), _flags(flags), _color(WHITE), _pt(pt), _shared(0), _reserved(0) {}
 
         ~Chunk() {
             if(!(_flags & Page_Flags::IO)) {
                 if(!((_flags & Page_Flags::CWT) || (_flags & Page_Flags::CD))) // CT == Strongly Ordered == C/B/TEX bits are 0
-                    free((*_pt)[_from], _to - _from);
+                    free(frame_at(_from), _to - _from);
                 else
-                    for( ; _from < _to; _from++)
-                        free((*_pt)[_from]);
+                    for(unsigned int i = _from; i < _to; i++)
+                        if(frame_at(i)) {
+                            if(!shared(i))
+                                release(frame_at(i));
+                        } else if(_reserved) // never populated nor shared
+                            white_free(reserved(i), 1);
             }
-            free(_pt, _pts);
+            if(_shared)
+                white_free(_shared, 1);
+            white_free(_pt, _pts);
         }
 
         unsigned int pts() const { return _pts; }
@@ -246,7 +317,7 @@ public:
         unsigned int size() const { return (_to - _from) * sizeof(Page); }
 
         Phy_Addr phy_address() const {
-            return (!((_flags & Page_Flags::CWT) || (_flags & Page_Flags::CD))) ? Phy_Addr(indexes((*_pt)[_from])) : Phy_Addr(false);
+            return (!((_flags & Page_Flags::CWT) || (_flags & Page_Flags::CD))) ? frame_at(_from) : Phy_Addr(false);
             // CT == Strongly Ordered == C/B/TEX bits are 0
         }
 
@@ -257,20 +328,63 @@ public:
 
         }
 
+        // Maps an existing frame (e.g. from the boot image) at page i; shared frames are not released with the chunk
+        void share(unsigned int i, Phy_Addr frame) {
+            if(!_shared)
+                _shared = calloc(1, WHITE);
+            i += _from;
+            if(frame_at(i)) {
+                if(!shared(i))
+                    release(frame_at(i));
+            } else if(_reserved)
+                white_free(reserved(i), 1);
+            _pt->remap(frame, i, i + 1, _flags);
+            static_cast<unsigned int *>(phy2log(_shared))[i / 32] |= 1 << (i % 32);
+        }
+
+        // Gives page i a private zeroed frame, unless it already has one, and returns the frame. The frame has the given
+        // color or else the chunk's, so the pages of a chunk can be spread over several colors
+        Phy_Addr populate(unsigned int i, Color color = WHITE) {
+            i += _from;
+            if(color == WHITE)
+                color = _color;
+            if(!frame_at(i) || shared(i)) {
+                Phy_Addr frame;
+                if(!frame_at(i) && _reserved && (color == WHITE)) {
+                    frame = reserved(i);
+                    memset(phy2log(frame), 0, sizeof(Page));
+                } else {
+                    if(!frame_at(i) && _reserved)
+                        white_free(reserved(i), 1);
+                    frame = calloc(1, color);
+                }
+                if(frame_at(i)) { // private copy of a shared frame
+                    memcpy(phy2log(frame), phy2log(frame_at(i)), sizeof(Page));
+                    static_cast<unsigned int *>(phy2log(_shared))[i / 32] &= ~(1 << (i % 32));
+                }
+                _pt->remap(frame, i, i + 1, _flags);
+                if(_reserved)
+                    promote(i);
+            }
+            return frame_at(i);
+        }
+
+        Phy_Addr frame(unsigned int i) const { return frame_at(i + _from); }
+
         int resize(unsigned int amount) {
             if(!((_flags & Page_Flags::CWT) || (_flags & Page_Flags::CD))) // CT == Strongly Ordered == C/B/TEX bits are 0
                 return 0;
 
             unsigned int pgs = pages(amount);
 
-            Color color = colorful ? phy2color(_pt) : WHITE;
+            Color color = _color;
 
             unsigned int free_pgs = _pts * PT_ENTRIES - _to;
             if(free_pgs < pgs) { // resize _pt
                 unsigned int pts = _pts + page_tables(pgs - free_pgs);
-                Page_Table * pt = calloc(pts, color);
+                Page_Table * pt = calloc(pts, WHITE);
                 memcpy(phy2log(pt), phy2log(_pt), _pts * sizeof(Page));
-                free(_pt, _pts);
+                white_free(_pt, _pts);
                 _pt = pt;
                 _pts = pts;
             }
@@ -281,30 +395,83 @@ public:
             return pgs * sizeof(Page);
         }
 
+        // Directory entry for the k-th page table of the chunk: a section wherever the table maps 1 MB of contiguous,
+        // 1 MB aligned frames with large pages only, so attaching it takes a single TLB entry instead of 16
+        PD_Entry pde(unsigned int k) const {
+            unsigned int first = k * PT_ENTRIES;
+            PT_Entry lpte = _pt->log()[first];
+            if((first < _from) || (first + PT_ENTRIES > _to) || !large(lpte) || (pte2phy(lpte, 0) & (SECTION_SIZE - 1)))
+                return phy2pde(Phy_Addr(_pt + k));
+            for(unsigned int i = LARGE_PAGES; i < PT_ENTRIES; i += LARGE_PAGES)
+                if(_pt->log()[first + i] != lpte + i * sizeof(Page))
+                    return phy2pde(Phy_Addr(_pt + k));
+            return phy2section(pte2phy(lpte, 0), _flags);
+        }
+
+    private:
+        Phy_Addr frame_at(unsigned int i) const { return pte2phy(_pt->log()[i], i); }
+        bool shared(unsigned int i) const { return _shared && (static_cast<unsigned int *>(phy2log(_shared))[i / 32] & (1 << (i % 32))); }
+        Phy_Addr reserved(unsigned int i) const { return _reserved + (i - _from) * sizeof(Page); }
+
+        // Frames of uncolored chunks (and reserved ones, which are always WHITE) go back to the WHITE list, so they
+        // can merge again into the runs they came from
+        void release(Phy_Addr frame) const {
+            if(_color == WHITE)
+                white_free(frame, 1);
+            else
+                free(frame);
+        }
+
+        // Turns the 64 KB group holding page i into a large page once all of its pages got their reserved frames
+        void promote(unsigned int i) {
+            i -= i % LARGE_PAGES;
+            if((i < _from) || (i + LARGE_PAGES > _to))
+                return;
+            for(unsigned int j = i; j < i + LARGE_PAGES; j++)
+                if((frame_at(j) != reserved(j)) || shared(j))
+                    return;
+            _pt->remap(reserved(i), i, i + LARGE_PAGES, _flags);
+        }
+
     private:
         unsigned int _from;
         unsigned int _to;
         unsigned int _pts;
         Page_Flags _flags;
+        Color _color; // of the frames of pages populated without one
         Page_Table * _pt; // this is a physical address
+        Phy_Addr _shared; // bitmap frame flagging pages mapped through share(), if any
+        Phy_Addr _reserved; // contiguous frames backing pages not yet populated (or 0), see reserve()
     };
 
     // Directory (for Address_Space)
     class Directory
     {
+    private:
+        // Attachments remembered for detach(const Chunk &), indexed by the chunk's page tables
+        static const unsigned int SLOTS = 32;
+
+        // Above this many invalidations by MVA, invalidating the whole TLB is cheaper
+        static const unsigned int INVALIDATIONS = 64;
+
+        struct Slot {
+            Page_Table * pt;
+            unsigned int from;
+        };
+
     public:
-        Directory() : _free(true) {
+        Directory() : _free(true), _slots() {
             // Page Directories have 4096 32-bit entries and must be aligned to 16Kb, thus, we need 7 frame in the worst case
             Phy_Addr pd = calloc(sizeof(Page_Directory) / sizeof(Frame) + ((sizeof(Page_Directory) / sizeof(Frame)) - 1), WHITE);
             unsigned int free_frames = 0;
             while(pd & (sizeof(Page_Directory) - 1)) { // pd is not aligned to 16 Kb
                 Phy_Addr * tmp = pd;
                 pd += sizeof(Frame); // skip this frame
-                free(tmp); // return this frame to the free list
+                white_free(tmp, 1); // return this frame to the free list
                 free_frames++;
             }
             if(free_frames != 3)
-                free(pd + 4 * sizeof(Page), 3 - free_frames); // return exceeding frames at the tail to the free list
+                white_free(pd + 4 * sizeof(Page), 3 - free_frames); // return exceeding frames at the tail to the free list
 
             _pd = static_cast<Page_Directory *>(pd);
 
@@ -313,9 +480,11 @@ public:
 
             for(unsigned int i = directory(SYS); i < PD_ENTRIES; i++)
                 (*_pd)[i] = (*_master)[i];
+
+            scan();
         }
 
-        Directory(Page_Directory * pd) : _pd(pd), _free(false) {}
+        Directory(Page_Directory * pd) : _pd(pd), _free(false), _slots() { scan(); }
 
         ~Directory() { if(_free) free(_pd, sizeof(Page_Directory) / sizeof(Page)); }
 
@@ -323,72 +492,185 @@ public:
 
         void activate() const { ARMv7_MMU::pd(_pd); }
 
+        // Attaching only fills invalid entries, which the TLBs never hold (translation faults are not cached), so no
+        // invalidation is needed, just making the new entries visible to the table walk. Entries detached through
+        // another Directory on the same PD are still marked as used here, so the bitmap is rebuilt before giving up.
         Log_Addr attach(const Chunk & chunk, unsigned int from = directory(APP_LOW)) {
-            flush_tlb();
-            for(unsigned int i = from; i < PD_ENTRIES; i++)
-                if(attach(i, chunk.pt(), chunk.pts(), chunk.flags()))
-                    return i << DIRECTORY_SHIFT;
+            for(unsigned int pass = 0; pass < 2; pass++) {
+                if(pass)
+                    scan();
+                for(unsigned int i = unused(from, chunk.pts()); i < PD_ENTRIES; i = unused(i + 1, chunk.pts()))
+                    if(attach(i, chunk))
+                        return i << DIRECTORY_SHIFT;
+            }
             return Log_Addr(false);
         }
 
         Log_Addr attach(const Chunk & chunk, Log_Addr addr) {
-            flush_tlb();
             unsigned int from = directory(addr);
-            if(attach(from, chunk.pt(), chunk.pts(), chunk.flags()))
+            if(attach(from, chunk))
                 return from << DIRECTORY_SHIFT;
             return Log_Addr(false);
         }
 
         void detach(const Chunk & chunk) {
-            flush_tlb();
-            for(unsigned int i = 0; i < PD_ENTRIES; i++) {
-                if(indexes(pte2phy((*_pd)[i])) == indexes(chunk.pt())) {
-                    detach(i, chunk.pt(), chunk.pts());
-                    return;
-                }
+            unsigned int from = lookup(chunk);
+            if(from == PD_ENTRIES) // forgotten (or attached through another Directory on the same PD), so search for it
+                for(from = 0; (from < PD_ENTRIES) && !attached(from, chunk); from++);
+            if(from == PD_ENTRIES) {
+                db<MMU>(WRN) << "MMU::Directory::detach(pt=" << chunk.pt() << ") failed!" << endl;
+                return;
             }
-            db<MMU>(WRN) << "MMU::Directory::detach(pt=" << chunk.pt() << ") failed!" << endl;
+            detach(from, chunk);
         }
 
         void detach(const Chunk & chunk, Log_Addr addr) {
-            flush_tlb();
             unsigned int from = directory(addr);
-            if(indexes(pte2phy((*_pd)[from])) != indexes(chunk.pt())) {
+            if(!attached(from, chunk)) {
                 db<MMU>(WRN) << "MMU::Directory::detach(pt=" << chunk.pt() << ",addr=" << addr << ") failed!" << endl;
                 return;
             }
-            detach(from, chunk.pt(), chunk.pts());
+            detach(from, chunk);
         }
 
-        Phy_Addr physical(Log_Addr addr) {
-            PD_Entry pde = (*_pd)[directory(addr)];
-            Page_Table * pt = static_cast<Page_Table *>(pde2phy(pde));
-            PT_Entry pte = pt->log()[page(addr)];
-            return pte | offset(addr);
-        }
+        Phy_Addr physical(Log_Addr addr) { return walk(_pd, addr); }
 
     private:
-        bool attach(unsigned int from, const Page_Table * pt, unsigned int n, Page_Flags flags) {
-            for(unsigned int i = from; i < from + n; i++)
-                if(_pd->log()[i])
+        // Page tables mapping whole 1 MB runs of contiguous frames are attached as sections (see Chunk::pde())
+        bool attach(unsigned int from, const Chunk & chunk) {
+            if(from + chunk.pts() > PD_ENTRIES)
+                return false;
+            for(unsigned int i = from; i < from + chunk.pts(); i++)
+                if(_pd->log()[i]) {
+                    use(i); // the bitmap is just a hint, entries might have been attached through another Directory
                     return false;
-            for(unsigned int i = from; i < from + n; i++, pt++)
-                _pd->log()[i] = phy2pde(Phy_Addr(pt));
+                }
+            for(unsigned int k = 0; k < chunk.pts(); k++) {
+                _pd->log()[from + k] = chunk.pde(k);
+                use(from + k);
+            }
+            _slots[slot(chunk.pt())].pt = chunk.pt();
+            _slots[slot(chunk.pt())].from = from;
+            CPU::dsb();
+            CPU::isb();
             return true;
         }
 
-        void detach(unsigned int from, const Page_Table * pt, unsigned int n) {
-            for(unsigned int i = from; i < from + n; i++) {
+        // The chunk's first page table was attached at entry i, either as such or promoted to a section (pages might
+        // have been populated since, so both are checked)
+        bool attached(unsigned int i, const Chunk & chunk) {
+            PD_Entry pde = _pd->log()[i];
+            return pde && ((pde == phy2pde(Phy_Addr(chunk.pt()))) || (pde == chunk.pde(0)));
+        }
+
+        // Invalidations go by the entries actually installed, read before clearing them, since the chunk might have
+        // been populated into sections after it was attached as page tables (see attached())
+        void detach(unsigned int from, const Chunk & chunk) {
+            bool by_mva = invalidating(from, chunk.pts());
+            for(unsigned int i = from; i < from + chunk.pts(); i++) {
+                PD_Entry pde = _pd->log()[i];
                 _pd->log()[i] = 0;
-                flush_tlb(i << DIRECTORY_SHIFT);
+                unuse(i);
+                if(by_mva && pde) {
+                    CPU::dsb();
+                    invalidate(i, pde, true);
+                }
             }
-            CPU::isb();
+            if(_slots[slot(chunk.pt())].pt == chunk.pt())
+                _slots[slot(chunk.pt())].pt = 0;
+            CPU::dsb();
+            if(!by_mva && (Traits<System>::multicore || (_pd == current())))
+                flush_tlb();
             CPU::dsb();
+            CPU::isb();
+        }
+
+        // Whether the TLB entries that might still translate the n entries at from are to be invalidated by MVA, one
+        // per page, large page or section. On a single core, only the active directory can have entries in the TLB,
+        // since activate() invalidates it all, and too many invalidations are replaced by a single flush_tlb().
+        // That is local to the core, though, so with multiple cores invalidations always go by MVA (broadcast).
+        bool invalidating(unsigned int from, unsigned int n) {
+            if(Traits<System>::multicore)
+                return true;
+            if(_pd != current())
+                return false;
+
+            unsigned int count = 0;
+            for(unsigned int i = from; (i < from + n) && (count <= INVALIDATIONS); i++)
+                if(_pd->log()[i])
+                    count += invalidate(i, _pd->log()[i], false);
+            return count <= INVALIDATIONS;
+        }
+
+        // Counts (and issues, if flush) the invalidations for the (non-empty) entry pde installed at i
+        static unsigned int invalidate(unsigned int i, PD_Entry pde, bool flush) {
+            Log_Addr addr = i << DIRECTORY_SHIFT;
+            if(section(pde)) {
+                if(flush)
+                    flush_tlb(addr);
+                return 1;
+            }
+
+            Page_Table * pt = static_cast<Page_Table *>(pde2phy(pde));
+            unsigned int n = 0;
+            for(unsigned int p = 0; p < PT_ENTRIES; addr += sizeof(Page)) {
+                PT_Entry pte = pt->log()[p];
+                unsigned int step = large(pte) ? LARGE_PAGES : 1;
+                if(pte) {
+                    if(flush)
+                        flush_tlb(addr);
+                    n++;
+                }
+                p += step;
+                addr += (step - 1) * sizeof(Page);
+            }
+            return n;
+        }
+
+        // Rebuilds the bitmap of used entries from the PD itself (slots are kept, lookup() checks them anyway)
+        void scan() {
+            for(unsigned int i = 0; i < PD_ENTRIES / 32; i++)
+                _used[i] = 0;
+            for(unsigned int i = 0; i < PD_ENTRIES; i++)
+                if(_pd->log()[i])
+                    use(i);
+        }
+
+        void use(unsigned int i) { _used[i / 32] |= 1 << (i % 32); }
+        void unuse(unsigned int i) { _used[i / 32] &= ~(1 << (i % 32)); }
+        bool used(unsigned int i) const { return _used[i / 32] & (1 << (i % 32)); }
+
+        // First entry at or after from that starts a run of n unused ones (PD_ENTRIES if none), skipping full words
+        unsigned int unused(unsigned int from, unsigned int n) const {
+            if(!n)
+                return from;
+            unsigned int run = 0;
+            for(unsigned int i = from; i < PD_ENTRIES; ) {
+                if(!(i % 32) && (_used[i / 32] == ~0U)) {
+                    run = 0;
+                    i += 32;
+                } else {
+                    run = used(i) ? 0 : run + 1;
+                    i++;
+                }
+                if(run >= n)
+                    return i - n;
+            }
+            return PD_ENTRIES;
         }
 
+        unsigned int lookup(const Chunk & chunk) {
+            const Slot & s = _slots[slot(chunk.pt())];
+            return ((s.pt == chunk.pt()) && attached(s.from, chunk)) ? s.from : PD_ENTRIES;
+        }
+
+        static unsigned int slot(Page_Table * pt) { return (Phy_Addr(pt) >> PAGE_SHIFT) % SLOTS; }
+
     private:
         Page_Directory * _pd;  // this is a physical address, but operator*() returns a logical address
         bool _free;
+        unsigned int _used[PD_ENTRIES / 32]; // bitmap of used entries, only a hint, since the PD has the final word
+        Slot _slots[SLOTS]; // reverse map of attached chunks (by their page tables) to entries (direct mapped)
     };
 
    // DMA_Buffer
@@ -428,13 +710,17 @@ public:
         friend OStream & operator<<(OStream & os, const Translation & t) {
             Page_Directory * pd = t._pd ? t._pd : current();
             PD_Entry pde = pd->log()[directory(t._addr)];
+            if(section(pde)) {
+                os << "{addr=" << static_cast<void *>(t._addr) << ",pd=" << pd << ",pd[" << directory(t._addr) << "]=" << pde << "(section),f=" << section2phy(pde) << ",*addr=" << hex << *static_cast<unsigned int *>(t._addr) << "}";
+                return os;
+            }
             Page_Table * pt = static_cast<Page_Table *>(pde2phy(pde));
             PT_Entry pte = pt->log()[page(t._addr)];
 
             os << "{addr=" << static_cast<void *>(t._addr) << ",pd=" << pd << ",pd[" << directory(t._addr) << "]=" << pde << ",pt=" << pt;
             if(t._show_pt)
                 os << "=>" << pt->log();
-            os << ",pt[" << page(t._addr) << "]=" << pte << ",f=" << pte2phy(pte) << ",*addr=" << hex << *static_cast<unsigned int *>(t._addr) << "}";
+            os << ",pt[" << page(t._addr) << "]=" << pte << (large(pte) ? "(large)" : "") << ",f=" << pte2phy(pte, page(t._addr)) << ",*addr=" << hex << *static_cast<unsigned int *>(t._addr) << "}";
             return os;
         }
 
@@ -447,19 +733,35 @@ public:
 public:
     ARMv7_MMU() {}
 
+    // Colored frames are handed out one at a time from the color's list, which is refilled from the WHITE one (see
+    // paint()). WHITE frames come from the WHITE list, or else from any color's list if a single one is asked for. Runs
+    // the WHITE list cannot hold anymore are searched again after the color lists are merged back into it (see bleach()).
     static Phy_Addr alloc(unsigned int frames = 1, Color color = WHITE) {
         Phy_Addr phy(false);
 
         if(frames) {
-            List::Element * e = _free[color].search_decrementing(frames);
+            List::Element * e = 0;
+            if(colorful && (color != WHITE)) {
+                if(frames == 1) {
+                    if(!_free[color].head())
+                        paint();
+                    e = _free[color].search_decrementing(1);
+                }
+            } else {
+                e = _free[WHITE].search_decrementing(frames);
+                if(colorful && !e) {
+                    if(frames == 1)
+                        for(unsigned int c = COLOR_1; !e && (c <= COLORS); c++)
+                            e = _free[c].search_decrementing(1);
+                    else if(bleach())
+                        e = _free[WHITE].search_decrementing(frames);
+                }
+            }
             if(e) {
                 phy = e->object() + e->size();
                 db<MMU>(TRC) << "MMU::alloc(frames=" << frames << ",color=" << color << ") => " << phy << endl;
             } else
-                if(colorful)
-                    db<MMU>(INF) << "MMU::alloc(frames=" << frames << ",color=" << color << ") => failed!" << endl;
-                else
-                    db<MMU>(WRN) << "MMU::alloc(frames=" << frames << ",color=" << color << ") => failed!" << endl;
+                db<MMU>(WRN) << "MMU::alloc(frames=" << frames << ",color=" << color << ") => failed!" << endl;
         }
 
         return phy;
@@ -471,10 +773,42 @@ public:
         return phy;
     }
 
+    // Allocates contiguous frames for pages [from, to) of a chunk, aligned like the pages themselves, so that every
+    // naturally aligned 64 KB group can be mapped with a large page and every whole page table with a section. The
+    // search is silent and falls back from 1 MB to 64 KB alignment; it fails if the range holds no aligned group or
+    // the memory is too fragmented, leaving it to alloc()
+    static Phy_Addr reserve(unsigned int from, unsigned int to, Color color = WHITE) {
+        if(colorful && (color != WHITE)) // contiguous frames span all colors
+            return Phy_Addr(false);
+
+        unsigned int frames = to - from;
+        for(unsigned int align = SECTION_SIZE; align >= LARGE_PAGE_SIZE; align /= PT_ENTRIES / LARGE_PAGES) {
+            unsigned int n = align / sizeof(Page);
+            if((from + n - 1) / n * n + n > to) // no whole aligned group in [from, to)
+                continue;
+            List::Element * e = _free[WHITE].search_decrementing(frames + n - 1);
+            if(!e && colorful && bleach())
+                e = _free[WHITE].search_decrementing(frames + n - 1);
+            if(!e)
+                continue;
+            unsigned int phy = Phy_Addr(e->object() + e->size());
+            unsigned int head = ((from * sizeof(Page) - phy) & (align - 1)) / sizeof(Page);
+            if(head)
+                white_free(phy, head);
+            if(n - 1 - head)
+                white_free(phy + (head + frames) * sizeof(Page), n - 1 - head);
+            db<MMU>(TRC) << "MMU::reserve(from=" << from << ",to=" << to << ",color=" << color << ") => " << reinterpret_cast<void *>(phy + head * sizeof(Page)) << endl;
+            return phy + head * sizeof(Page);
+        }
+        return Phy_Addr(false);
+    }
+
+    // Single frames go to the list of their color, runs go back to the WHITE list so they remain contiguous. Frames that
+    // were not handed out by color (e.g. page tables and reserved frames) should go through white_free() instead.
     static void free(Phy_Addr frame, int n = 1) {
         // Clean up MMU flags in frame address
         frame = indexes(frame);
-        Color color = colorful ? phy2color(frame) : WHITE;
+        Color color = (colorful && (n == 1)) ? phy2color(frame) : WHITE;
 
         db<MMU>(TRC) << "MMU::free(frame=" << frame << ",color=" << color << ",n=" << n << ")" << endl;
 
@@ -502,17 +836,37 @@ public:
 
     static Page_Directory * volatile current() { return static_cast<Page_Directory * volatile>(pd());}
 
-    static Phy_Addr physical(Log_Addr addr) {
-        Page_Directory * pd = current();
-        Page_Table * pt = pd->log()[directory(addr)];
-        return pt->log()[page(addr)] | offset(addr);
-    }
+    static Phy_Addr physical(Log_Addr addr) { return walk(current(), addr); }
 
     static PT_Entry phy2pte(Phy_Addr frame, Page_Flags flags) { return (frame) | flags | Page_Flags::PTE; }
     static Phy_Addr pte2phy(PT_Entry entry) { return (entry & ~Page_Flags::PT_MASK); }
     static PD_Entry phy2pde(Phy_Addr frame) { return (frame) | Page_Flags::PD_FLAGS; }
     static Phy_Addr pde2phy(PD_Entry entry) { return (entry & ~Page_Flags::PD_MASK); }
 
+    // Large pages: all LARGE_PAGES entries of a 64 KB aligned group hold the same descriptor
+    static bool large(PT_Entry entry) { return (entry & (Page_Flags::PTE | Page_Flags::LPTE)) == Page_Flags::LPTE; }
+    static PT_Entry phy2lpte(Phy_Addr frame, Page_Flags flags) {
+        return (frame & ~Page_Flags::LP_MASK) | (flags & ~(Page_Flags::XN | Page_Flags::PTE | Page_Flags::TEX))
+             | ((flags & Page_Flags::TEX) << 6) | ((flags & Page_Flags::XN) ? Page_Flags::LXN : 0) | Page_Flags::LPTE;
+    }
+    static PT_Entry lpte2pte(PT_Entry entry, unsigned int i) {
+        return pte2phy(entry, i) | (entry & (Page_Flags::PT_MASK & ~(Page_Flags::LPTE | Page_Flags::TEX)))
+             | ((entry >> 6) & Page_Flags::TEX) | ((entry & Page_Flags::LXN) ? Page_Flags::XN : 0) | Page_Flags::PTE;
+    }
+    // Frame mapped by entry i of a page table, be it a small page or part of a large one
+    static Phy_Addr pte2phy(PT_Entry entry, unsigned int i) {
+        return large(entry) ? Phy_Addr((entry & ~Page_Flags::LP_MASK) + (i % LARGE_PAGES) * sizeof(Page)) : pte2phy(entry);
+    }
+
+    // Sections map a whole directory entry (1 MB) without a page table
+    static bool section(PD_Entry entry) { return (entry & (Page_Flags::PDE | Page_Flags::SECTION)) == Page_Flags::SECTION; }
+    static PD_Entry phy2section(Phy_Addr frame, Page_Flags flags) {
+        return (frame & ~Page_Flags::SECTION_MASK) | (flags & (Page_Flags::B | Page_Flags::C)) | ((flags & Page_Flags::XN) ? Page_Flags::SXN : 0)
+             | ((flags & (Page_Flags::AP0 | Page_Flags::AP1 | Page_Flags::TEX | Page_Flags::AP2 | Page_Flags::S | Page_Flags::nG)) << 6)
+             | Page_Flags::SNS | Page_Flags::SECTION;
+    }
+    static Phy_Addr section2phy(PD_Entry entry) { return (entry & ~Page_Flags::SECTION_MASK); }
+
     static void flush_tlb() {
         CPU::isb();
         CPU::dsb();
@@ -529,22 +883,50 @@ public:
     static Log_Addr phy2log(Phy_Addr phy) { return Log_Addr((RAM_BASE == PHY_MEM) ? phy : (RAM_BASE > PHY_MEM) ? phy - (RAM_BASE - PHY_MEM) : phy + (PHY_MEM - RAM_BASE)); }
     static Phy_Addr log2phy(Log_Addr log) { return Phy_Addr((RAM_BASE == PHY_MEM) ? log : (RAM_BASE > PHY_MEM) ? log + (RAM_BASE - PHY_MEM) : log - (PHY_MEM - RAM_BASE)); }
 
-    static Color phy2color(Phy_Addr phy) { return static_cast<Color>(colorful ? ((phy >> PAGE_SHIFT) & 0x7f) % COLORS : WHITE); } // TODO: what is 0x7f
+    // Frames COLORS pages apart map to the same L2 cache sets. Colors are numbered from COLOR_1, since WHITE (COLOR_0)
+    // stands for frames of any color.
+    static Color phy2color(Phy_Addr phy) { return static_cast<Color>(colorful ? COLOR_1 + (phy >> PAGE_SHIFT) % COLORS : WHITE); }
 
-    static Color log2color(Log_Addr log) {
-        if(colorful) {
-            Page_Directory * pd = current();
-            Page_Table * pt = (*pd)[directory(log)];
-            Phy_Addr phy = (*pt)[page(log)] | offset(log);
-            return static_cast<Color>(((phy >> PAGE_SHIFT) & 0x7f) % COLORS);
-        } else
-            return WHITE;
-    }
+    static Color log2color(Log_Addr log) { return colorful ? phy2color(physical(log)) : WHITE; }
 
 private:
     static Phy_Addr pd() { return CPU::ttbr0(); }
+
+    // Translates addr through the page directory pd (a physical address), following sections and large pages
+    static Phy_Addr walk(Page_Directory * pd, Log_Addr addr) {
+        PD_Entry pde = pd->log()[directory(addr)];
+        if(section(pde))
+            return section2phy(pde) | (addr & (SECTION_SIZE - 1));
+        Page_Table * pt = static_cast<Page_Table *>(pde2phy(pde));
+        return pte2phy(pt->log()[page(addr)], page(addr)) | offset(addr);
+    }
+
     static void pd(Phy_Addr pd) { CPU::ttbr0(pd); CPU::flush_tlb(); CPU::isb(); CPU::dsb(); }
 
+    // Moves a run of COLORS frames (one of each color) from the WHITE list to the lists of their colors
+    static void paint() {
+        List::Element * e = _free[WHITE].search_decrementing(COLORS);
+        if(!e)
+            return;
+        Phy_Addr phy = e->object() + e->size();
+        for(unsigned int i = 0; i < COLORS; i++, phy += sizeof(Frame))
+            free(phy);
+    }
+
+    // Merges the frames in the color lists back into the WHITE one, so that frames freed one at a time can again be
+    // part of runs. Returns whether any frame was moved.
+    static bool bleach() {
+        bool moved = false;
+        for(unsigned int c = COLOR_1; c <= COLORS; c++)
+            while(List::Element * e = _free[c].head()) {
+                unsigned int n = e->size();
+                _free[c].search_decrementing(n);
+                white_free(e->object(), n);
+                moved = true;
+            }
+        return moved;
+    }
+
     //static void flush_tlb() { CPU::flush_tlb(); }
     static void flush_tlb(Log_Addr addr) { CPU::flush_tlb(directory_bits(addr)); } // only bits from 31 to 12, all ASIDs
 
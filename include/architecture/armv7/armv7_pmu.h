@@ -178,6 +178,9 @@ public:
         write(channel, 0);
     }
 
+    // Free-running cycle counter (PMCCNTR), enabled by init()
+    static Reg32 cycles() { return pmccntr(); }
+
     static void init();
 
 private:
@@ -196,6 +199,8 @@ private:
     static void pmselr(Reg32 reg) { ASM("mcr p15, 0, %0, c9, c12, 5\n\t" : : "r"(reg)); }
     static Reg32 pmselr() { Reg32 reg; ASM("mrc p15, 0, %0, c9, c12, 5\n\t" : "=r"(reg) : ); return reg; }
 
+    static Reg32 pmccntr() { Reg32 reg; ASM("mrc p15, 0, %0, c9, c13, 0\n\t" : "=r"(reg) : ); return reg; }
+
     static void pmxevtyper(const Reg32 reg) { ASM("mcr p15, 0, %0, c9, c13, 1\n\t" : : "r"(reg)); }
     static Reg32 pmxevtyper() { Reg32 reg; ASM("mrc p15, 0, %0, c9, c13, 1\n\t" : "=r"(reg) : ); return reg; }
 
@@ -232,6 +237,7 @@ public:
     using Engine::start;
     using Engine::stop;
     using Engine::reset;
+    using Engine::cycles;
 
 private:
     static void init() { Engine::init(); }
@@ -17,8 +17,10 @@ template<> struct Traits<CPU>: public Traits<Build>
 
 template<> struct Traits<MMU>: public Traits<Build>
 {
-    static const bool colorful = false;
-    static const unsigned int COLORS = 1;
+    // Page colors = L2 cache way size / page size: Cortex-A53 (512 KB, 16 ways) and Cortex-A9's PL310 (512 KB, 8 ways)
+    // Colors are only handed out to tasks that ask for them (see Palette), everything else keeps using WHITE frames
+    static const unsigned int COLORS = (Traits<Build>::MODEL == Traits<Build>::Raspberry_Pi3) ? 8 : (Traits<Build>::MODEL == Traits<Build>::Zynq) ? 16 : 1;
+    static const bool colorful = (COLORS > 1);
 };
 
 template<> struct Traits<FPU>: public Traits<Build>
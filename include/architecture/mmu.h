@@ -99,6 +99,11 @@ public:
     // Page Flags
     typedef Flags Page_Flags;
 
+    // Superpages (SETUP code is shared with paging configurations; without paging there is nothing to group)
+    static const unsigned int LARGE_PAGES = 1;
+    static const unsigned int LARGE_PAGE_SIZE = 1;
+    static const unsigned int SECTION_SIZE = 1;
+
     // Page_Table
     class Page_Table {
         friend OStream & operator<<(OStream & os, Page_Table & pt) {
@@ -113,6 +118,7 @@ public:
     public:
         Chunk() {}
         Chunk(unsigned int bytes, Flags flags, Color color = WHITE): _phy_addr(alloc(bytes)), _bytes(bytes), _flags(flags) {}
+        Chunk(unsigned int bytes, Flags flags, Color color, bool populated): _phy_addr(alloc(bytes)), _bytes(bytes), _flags(flags) {}
         Chunk(Phy_Addr phy_addr, unsigned int bytes, Flags flags): _phy_addr(phy_addr), _bytes(bytes), _flags(flags) {}
         Chunk(Phy_Addr pt, unsigned int from, unsigned int to, Flags flags): _phy_addr(0), _bytes(0), _flags(flags) {}
 
@@ -125,6 +131,10 @@ public:
         Phy_Addr phy_address() const { return _phy_addr; } // always CT
         int resize(unsigned int amount) { return 0; } // no resize in CT
 
+        void share(unsigned int i, Phy_Addr frame) {} // no sharing without paging, the loader copies instead
+        Phy_Addr populate(unsigned int i, Color color = WHITE) { return frame(i); }
+        Phy_Addr frame(unsigned int i) const { return _phy_addr + i * sizeof(Page); }
+
     private:
         Phy_Addr _phy_addr;
         unsigned int _bytes;
@@ -231,6 +241,8 @@ public:
     static Phy_Addr pte2phy(PT_Entry entry) { return entry; }
     static PD_Entry phy2pde(Phy_Addr frame) { return frame; }
     static Phy_Addr pde2phy(PD_Entry entry) { return entry; }
+    static PT_Entry phy2lpte(Phy_Addr frame, Flags flags) { return frame; }
+    static PD_Entry phy2section(Phy_Addr frame, Flags flags) { return frame; }
 
     static Log_Addr phy2log(Phy_Addr phy) { return phy; }
     static Phy_Addr log2phy(Log_Addr log) { return log; }
@@ -430,7 +430,7 @@ public:
 
 private:
     static Phy_Addr pd() { return CPU::satp() << 12; }
-    static void pd(Phy_Addr pd) { CPU::satp((1 << 31) | (pd >> 12)); }
+    static void pd(Phy_Addr pd) { CPU::satp((1 << 31) | (pd >> 12)); flush_tlb(); } // without ASIDs, nothing survives
 
     static void flush_tlb() { CPU::flush_tlb(); }
     static void flush_tlb(Log_Addr addr) { CPU::flush_tlb(addr); }
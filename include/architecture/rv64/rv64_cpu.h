@@ -55,6 +55,12 @@ public:
         MEI             = 1 << 11   // Machine External Interrupt
     };
 
+    // Supervisor Address Translation and Protection Register (satp)
+    static const Reg64 SATP_SV39        = 8ULL << 60;                   // MODE = Sv39 (three-level, 39-bit virtual addresses)
+    static const Reg64 SATP_ASID        = 0xffffULL << 44;              // Address Space Identifier (WARL, up to 16 bits)
+    static const Reg64 SATP_PPN         = (1ULL << 44) - 1;             // Physical Page Number of the root page table
+    static const unsigned int SATP_ASID_SHIFT = 44;
+
     // Exceptions (mcause with interrupt = 0)
     static const unsigned int EXCEPTIONS = 12;
     enum {
@@ -183,8 +189,13 @@ public:
 
     static Log_Addr ip() { Reg32 r; ASM("auipc %0, 0" : "=r"(r) :); return r; }
 
-    static Reg32 pdp() { return sup ? (satp() << 12) : 0; }
-    static void pdp(Reg32 pdp) { if(sup) satp((1 << 31) | (pdp >> 12)); }
+    static Reg32 pdp() { return sup ? ((satp() & SATP_PPN) << 12) : 0; }
+    static void pdp(Reg32 pdp, unsigned int asid = 0) { if(sup) satp(SATP_SV39 | (Reg64(asid) << SATP_ASID_SHIFT) | (pdp >> 12)); }
+    static unsigned int asid() { return (satp() & SATP_ASID) >> SATP_ASID_SHIFT; }
+
+    static void flush_tlb() { ASM("sfence.vma" : : : "memory"); }
+    static void flush_tlb(Reg32 addr) { ASM("sfence.vma %0" : : "r"(addr) : "memory"); }
+    static void flush_asid(Reg32 asid) { ASM("sfence.vma zero, %0" : : "r"(asid) : "memory"); }
 
     static unsigned int id() { return sup ? tp() : mhartid(); }
 
@@ -346,8 +357,8 @@ public:
 
     static void sret() { ASM("sret"); }
 
-    static void satp(Reg32 r) { ASM("csrw satp, %0" : : "r"(r) : "cc"); }
-    static Reg  satp() { Reg r; ASM("csrr %0, satp" : "=r"(r) : : ); return r; }
+    static void satp(Reg64 r) { ASM("csrw satp, %0" : : "r"(r) : "cc"); }
+    static Reg64 satp() { Reg64 r; ASM("csrr %0, satp" : "=r"(r) : : ); return r; }
 
 private:
     template<typename Head, typename ... Tail>
@@ -12,9 +12,12 @@
 
 __BEGIN_SYS
 
-class RV32S_MMU: public MMU_Common<10, 10, 12>
+// Sv39 paging for EPOS' 32-bit logical address space: the 4 GB are covered by 4 entries of the root (level 2) table, so
+// the 4 level-1 tables below it are kept contiguous and indexed as a single 2048-entry Page_Directory of 2 MB entries
+class SV39_MMU: public MMU_Common<11, 9, 12>
 {
     friend class CPU;
+    friend class Setup;
 
 private:
     typedef Grouping_List<Frame> List;
@@ -24,8 +27,22 @@ private:
     static const unsigned int RAM_BASE = Memory_Map::RAM_BASE;
     static const unsigned int APP_LOW = Memory_Map::APP_LOW;
     static const unsigned int PHY_MEM = Memory_Map::PHY_MEM;
+    static const unsigned int SYS = Memory_Map::SYS;
+    static const unsigned int IO = Memory_Map::IO;
 
 public:
+    // Sv39 entries are 64 bits wide
+    typedef CPU::Reg64 PT_Entry;
+    typedef CPU::Reg64 PD_Entry;
+
+    // Superpages: a leaf in the Page_Directory maps a megapage, a leaf in the root table maps a gigapage
+    static const unsigned int MEGA_PAGE_SIZE = 1 << DIRECTORY_SHIFT;
+    static const unsigned int GIGA_PAGE_SHIFT = DIRECTORY_SHIFT + 9;
+    static const unsigned int ROOT_ENTRIES = PD_ENTRIES / PT_ENTRIES;
+
+    // Address Space Identifiers handed out to Directories (ASID 0 is the master's and is shared on exhaustion)
+    static const unsigned int ASIDS = 64;
+
     // Page Flags
     class Page_Flags
     {
@@ -41,18 +58,23 @@ public:
             D    = 1 << 7, // Dirty
             CT   = 1 << 8, // Contiguous (reserved for use by supervisor RSW)
             MIO  = 1 << 9, // I/O (reserved for use by supervisor RSW)
-            APP  = (V | R | W | X),
+            APP  = (V | R | W | X | U),
+            APPC = (V | R | X | U),
+            APPD = (V | R | W | U),
             SYS  = (V | R | W | X),
             IO   = (SYS | MIO),
             DMA  = (SYS | CT),
+            LEAF = (R | W | X), // non-leaf entries have none of these
             MASK = (1 << 10) - 1
         };
 
     public:
         Page_Flags() {}
         Page_Flags(unsigned int f) : _flags(f) {}
-        Page_Flags(Flags f) : _flags(V | R | X |
+        Page_Flags(Flags f) : _flags(V |
+                                     ((f & Flags::RD)  ? R  : 0) |
                                      ((f & Flags::RW)  ? W  : 0) |
+                                     ((f & Flags::EX)  ? X  : 0) |
                                      ((f & Flags::USR) ? U  : 0) |
                                      ((f & Flags::CWT) ? 0  : 0) |
                                      ((f & Flags::CD)  ? 0  : 0) |
@@ -74,6 +96,7 @@ public:
         Page_Table() {}
 
         PT_Entry & operator[](unsigned int i) { return _entry[i]; }
+        Page_Table & log() { return *static_cast<Page_Table *>(phy2log(this)); }
 
         void map(int from, int to, Page_Flags flags, Color color) {
             Phy_Addr * addr = alloc(to - from, color);
@@ -81,7 +104,7 @@ public:
                 remap(addr, from, to, flags);
             else
                 for( ; from < to; from++) {
-                    Log_Addr * pte = phy2log(&_entry[from]);
+                    PT_Entry * pte = phy2log(&_entry[from]);
                     *pte = phy2pte(alloc(1, color), flags);
                 }
         }
@@ -93,7 +116,7 @@ public:
         void remap(Phy_Addr addr, int from, int to, Page_Flags flags) {
             addr = align_page(addr);
             for( ; from < to; from++) {
-                Log_Addr * pte = phy2log(&_entry[from]);
+                PT_Entry * pte = phy2log(&_entry[from]);
                 *pte = phy2pte(addr, flags);
                 addr += sizeof(Page);
             }
@@ -101,9 +124,9 @@ public:
 
         void unmap(int from, int to) {
             for( ; from < to; from++) {
-                free(_entry[from]);
-                Log_Addr * tmp = phy2log(&_entry[from]);
-                *tmp = 0;
+                free(pte2phy(log()[from]));
+                PT_Entry * pte = phy2log(&_entry[from]);
+                *pte = 0;
             }
         }
 
@@ -112,7 +135,7 @@ public:
             int brk = 0;
             for(unsigned int i = 0; i < PT_ENTRIES; i++)
                 if(pt[i]) {
-                    os << "[" << i << "]=" << reinterpret_cast<void *>((pt[i] & ~Page_Flags::MASK) << 2 | (pt[i] & Page_Flags::MASK)) << "  ";
+                    os << "[" << i << "]=" << pte2phy(pt[i]) << "  ";
                     if(!(++brk % 4))
                         os << "\n";
                 }
@@ -121,7 +144,46 @@ public:
         }
 
     private:
-        PT_Entry _entry[PT_ENTRIES];
+        PT_Entry _entry[PT_ENTRIES]; // the Phy_Addr in each entry passed through phy2pte()
+    };
+
+    // Page Directory (the root table followed by the 4 level-1 tables it points to)
+    class Page_Directory
+    {
+    public:
+        Page_Directory() {}
+
+        PD_Entry & operator[](unsigned int i) { return _entry[i]; }
+        Page_Directory & log() { return *static_cast<Page_Directory *>(phy2log(this)); }
+
+        PT_Entry & root(unsigned int i) { return _root[i]; }
+
+        // Points the root table at the level-1 tables; phy is the physical address of this directory.
+        // RV64 sign-extends 32-bit addresses above 2 GB, so those are also reached from the top of the root table.
+        void link(Phy_Addr phy) {
+            for(unsigned int i = 0; i < ROOT_ENTRIES; i++) {
+                _root[i] = phy2pde(phy + sizeof(Page_Table) * (i + 1));
+                if(i >= ROOT_ENTRIES / 2)
+                    _root[PT_ENTRIES - ROOT_ENTRIES + i] = _root[i];
+            }
+        }
+
+        friend OStream & operator<<(OStream & os, Page_Directory & pd) {
+            os << "{\n";
+            int brk = 0;
+            for(unsigned int i = 0; i < PD_ENTRIES; i++)
+                if(pd[i]) {
+                    os << "[" << i << "]=" << pte2phy(pd[i]) << (leaf(pd[i]) ? "M  " : "  ");
+                    if(!(++brk % 4))
+                        os << "\n";
+                }
+            os << "\n}";
+            return os;
+        }
+
+    private:
+        PT_Entry _root[PT_ENTRIES];
+        PD_Entry _entry[PD_ENTRIES];
     };
 
     // Chunk (for Segment)
@@ -131,26 +193,39 @@ public:
         Chunk() {}
 
         Chunk(unsigned int bytes, Flags flags, Color color = WHITE)
-        : _from(0), _to(pages(bytes)), _pts(page_tables(_to - _from)), _flags(Page_Flags(flags)), _pt(calloc(_pts, WHITE)) {
+        : _from(0), _to(pages(bytes)), _pts(page_tables(_to - _from)), _flags(Page_Flags(flags)), _pt(calloc(_pts, WHITE)), _shared(0) {
             if(_flags & Page_Flags::CT)
                 _pt->map_contiguous(_from, _to, _flags, color);
             else
                 _pt->map(_from, _to, _flags, color);
         }
 
+        // Only the page tables are allocated; pages are later given frames with share() or populate()
+        Chunk(unsigned int bytes, Flags flags, Color color, bool populated)
+        : _from(0), _to(pages(bytes)), _pts(page_tables(_to - _from)), _flags(Page_Flags(flags)), _pt(calloc(_pts, WHITE)), _shared(0) {
+            if(populated)
+                _pt->map(_from, _to, _flags, color);
+        }
+
         Chunk(Phy_Addr phy_addr, unsigned int bytes, Flags flags)
-        : _from(0), _to(pages(bytes)), _pts(page_tables(_to - _from)), _flags(Page_Flags(flags)), _pt(calloc(_pts, WHITE)) {
-            _pt->remap(phy_addr, _from, _to, flags);
+        : _from(0), _to(pages(bytes)), _pts(page_tables(_to - _from)), _flags(Page_Flags(flags)), _pt(calloc(_pts, WHITE)), _shared(0) {
+            _pt->remap(phy_addr, _from, _to, _flags);
         }
 
+        Chunk(Phy_Addr pt, unsigned int from, unsigned int to, Flags flags)
+        : _from(from), _to(to), _pts(page_tables(_to - _from)), _flags(flags), _pt(pt), _shared(0) {}
+
         ~Chunk() {
             if(!(_flags & Page_Flags::IO)) {
                 if(_flags & Page_Flags::CT)
-                    free((*static_cast<Page_Table *>(phy2log(_pt)))[_from], _to - _from);
+                    free(frame_at(_from), _to - _from);
                 else
                     for( ; _from < _to; _from++)
-                        free((*static_cast<Page_Table *>(phy2log(_pt)))[_from]);
+                        if(!shared(_from))
+                            free(frame_at(_from));
             }
+            if(_shared)
+                free(_shared);
             free(_pt, _pts);
         }
 
@@ -160,9 +235,36 @@ public:
         unsigned int size() const { return (_to - _from) * sizeof(Page); }
 
         Phy_Addr phy_address() const {
-            return (_flags & Page_Flags::CT) ? Phy_Addr(indexes((*_pt)[_from])) : Phy_Addr(false);
+            return (_flags & Page_Flags::CT) ? frame_at(_from) : Phy_Addr(false);
+        }
+
+        // Maps an existing frame (e.g. from the boot image) at page i; shared frames are not released with the chunk
+        void share(unsigned int i, Phy_Addr frame) {
+            if(!_shared)
+                _shared = calloc(1, WHITE);
+            i += _from;
+            if(frame_at(i) && !shared(i))
+                free(frame_at(i));
+            _pt->remap(frame, i, i + 1, _flags);
+            static_cast<unsigned int *>(phy2log(_shared))[i / 32] |= 1 << (i % 32);
+        }
+
+        // Gives page i a private zeroed frame (of the given color, if any), unless it already has one, and returns the frame
+        Phy_Addr populate(unsigned int i, Color color = WHITE) {
+            i += _from;
+            if(!frame_at(i) || shared(i)) {
+                Phy_Addr frame = calloc(1, colorful ? ((color != WHITE) ? color : phy2color(_pt)) : WHITE);
+                if(frame_at(i)) { // private copy of a shared frame
+                    memcpy(phy2log(frame), phy2log(frame_at(i)), sizeof(Page));
+                    static_cast<unsigned int *>(phy2log(_shared))[i / 32] &= ~(1 << (i % 32));
+                }
+                _pt->remap(frame, i, i + 1, _flags);
+            }
+            return frame_at(i);
         }
 
+        Phy_Addr frame(unsigned int i) const { return frame_at(i + _from); }
+
         int resize(unsigned int amount) {
             if(_flags & Page_Flags::CT)
                 return 0;
@@ -175,7 +277,7 @@ public:
             if(free_pgs < pgs) { // resize _pt
                 unsigned int pts = _pts + page_tables(pgs - free_pgs);
                 Page_Table * pt = calloc(pts, color);
-                memcpy(pt, _pt, _pts * sizeof(Page));
+                memcpy(phy2log(pt), phy2log(_pt), _pts * sizeof(Page));
                 free(_pt, _pts);
                 _pt = pt;
                 _pts = pts;
@@ -187,33 +289,56 @@ public:
             return pgs * sizeof(Page);
         }
 
+    private:
+        Phy_Addr frame_at(unsigned int i) const { return pte2phy(_pt->log()[i]); }
+        bool shared(unsigned int i) const { return _shared && (static_cast<unsigned int *>(phy2log(_shared))[i / 32] & (1 << (i % 32))); }
+
     private:
         unsigned int _from;
         unsigned int _to;
         unsigned int _pts;
         Page_Flags _flags;
-        Page_Table * _pt;
+        Page_Table * _pt; // this is a physical address
+        Phy_Addr _shared; // bitmap frame flagging pages mapped through share(), if any
     };
 
-    // Page Directory
-    typedef Page_Table Page_Directory;
-
     // Directory (for Address_Space)
     class Directory
     {
     public:
-        Directory() : _pd(phy2log(calloc(1, WHITE))), _free(true) {
-            for(unsigned int i = directory(PHY_MEM); i < PD_ENTRIES; i++)
-                (*_pd)[i] = (*_master)[i];
+        Directory() : _pd(calloc(sizeof(Page_Directory) / sizeof(Frame), WHITE)), _asid(asid_alloc()), _free(true) {
+            Page_Directory & pd = _pd->log();
+            pd.link(_pd);
+
+            for(unsigned int i = directory(IO); i < directory(APP_LOW); i++)
+                pd[i] = _master->log()[i];
+
+            for(unsigned int i = directory(SYS); i < PD_ENTRIES; i++)
+                pd[i] = _master->log()[i];
         }
 
-        Directory(Page_Directory * pd) : _pd(pd), _free(false) {}
+        Directory(Page_Directory * pd) : _pd(pd), _asid(pd == _master ? 0 : pd2asid(pd)), _free(false) {}
 
-        ~Directory() { if(_free) free(_pd); }
+        ~Directory() {
+            if(_free) {
+                if(_asid) {
+                    CPU::flush_asid(_asid); // the next owner of this ASID must not see our translations
+                    asid_free(_asid);
+                } else
+                    flush_tlb();
+                free(_pd, sizeof(Page_Directory) / sizeof(Frame));
+            }
+        }
 
         Phy_Addr pd() const { return _pd; }
+        unsigned int asid() const { return _asid; }
 
-        void activate() const { CPU::pdp(reinterpret_cast<CPU::Reg32>(_pd)); }
+        // Translations are tagged with the ASID, so only directories sharing ASID 0 need the TLB flushed on a switch
+        void activate() const {
+            CPU::pdp(Phy_Addr(_pd), _asid);
+            if(!_asid)
+                flush_tlb();
+        }
 
         Log_Addr attach(const Chunk & chunk, unsigned int from = directory(APP_LOW)) {
             for(unsigned int i = from; i < PD_ENTRIES; i++)
@@ -231,7 +356,7 @@ public:
 
         void detach(const Chunk & chunk) {
             for(unsigned int i = 0; i < PD_ENTRIES; i++) {
-                if(indexes((*_pd)[i]) == indexes(phy2pde(chunk.pt()))) {
+                if(!leaf(_pd->log()[i]) && (pte2phy(_pd->log()[i]) == Phy_Addr(chunk.pt()))) {
                     detach(i, chunk.pt(), chunk.pts());
                     return;
                 }
@@ -241,35 +366,40 @@ public:
 
         void detach(const Chunk & chunk, Log_Addr addr) {
             unsigned int from = directory(addr);
-            if(indexes((*_pd)[from]) != indexes(chunk.pt())) {
+            if(leaf(_pd->log()[from]) || (pte2phy(_pd->log()[from]) != Phy_Addr(chunk.pt()))) {
                 db<MMU>(WRN) << "MMU::Directory::detach(pt=" << chunk.pt() << ",addr=" << addr << ") failed!" << endl;
                 return;
             }
             detach(from, chunk.pt(), chunk.pts());
         }
 
-        Phy_Addr physical(Log_Addr addr) {
-            Page_Table * pt = reinterpret_cast<Page_Table *>((void *)(*_pd)[directory(addr)]);
-            return (*pt)[page(addr)] | offset(addr);
-        }
+        Phy_Addr physical(Log_Addr addr) { return walk(_pd, addr); }
 
     private:
         bool attach(unsigned int from, const Page_Table * pt, unsigned int n, Page_Flags flags) {
+            if(from + n > PD_ENTRIES)
+                return false;
             for(unsigned int i = from; i < from + n; i++)
-                if((*_pd)[i])
+                if(_pd->log()[i])
                     return false;
             for(unsigned int i = from; i < from + n; i++, pt++)
-                (*_pd)[i] = phy2pde(Phy_Addr(pt));
+                _pd->log()[i] = phy2pde(Phy_Addr(pt));
             return true;
         }
 
+        // Non-leaf entries changed, so a single-address fence would not do; drop everything tagged with our ASID
         void detach(unsigned int from, const Page_Table * pt, unsigned int n) {
             for(unsigned int i = from; i < from + n; i++)
-                (*_pd)[i] = 0;
+                _pd->log()[i] = 0;
+            if(_asid)
+                CPU::flush_asid(_asid);
+            else
+                flush_tlb();
         }
 
     private:
-        Page_Directory * _pd;
+        Page_Directory * _pd;  // this is a physical address, but log() returns a logical reference
+        unsigned int _asid;
         bool _free;
     };
 
@@ -308,15 +438,27 @@ public:
         Translation(Log_Addr addr, bool pt = false, Page_Directory * pd = 0): _addr(addr), _show_pt(pt), _pd(pd) {}
 
         friend OStream & operator<<(OStream & os, const Translation & t) {
-            Page_Directory * pd = t._pd ? t._pd : reinterpret_cast<Page_Directory *>(CPU::satp() << 12);
-            PD_Entry pde = (*pd)[directory(t._addr)];
-            Page_Table * pt = static_cast<Page_Table *>(pde2phy(pde));
-            PT_Entry pte = (*pt)[page(t._addr)];
+            Page_Directory * pd = t._pd ? t._pd : current();
+            PT_Entry root = pd->log().root(t._addr >> GIGA_PAGE_SHIFT);
+            os << "{addr=" << static_cast<void *>(t._addr) << ",pd=" << pd << ",root[" << (t._addr >> GIGA_PAGE_SHIFT) << "]=" << root;
+            if(leaf(root)) {
+                os << ",f=" << pte2phy(root) << "(G),*addr=" << hex << *static_cast<unsigned int *>(t._addr) << "}";
+                return os;
+            }
+
+            PD_Entry pde = pd->log()[directory(t._addr)];
+            os << ",pd[" << directory(t._addr) << "]=" << pde;
+            if(leaf(pde)) {
+                os << ",f=" << pte2phy(pde) << "(M),*addr=" << hex << *static_cast<unsigned int *>(t._addr) << "}";
+                return os;
+            }
 
-            os << "{addr=" << static_cast<void *>(t._addr) << ",pd=" << pd << ",pd[" << directory(t._addr) << "]=" << pde2phy(pde);
+            Page_Table * pt = static_cast<Page_Table *>(pde2phy(pde));
+            PT_Entry pte = pt->log()[page(t._addr)];
+            os << ",pt=" << pt;
             if(t._show_pt)
-                os << ",pt=" << *pt;
-            os << ",pt[" << page(t._addr) << "]=" << pte2phy(pte) << ",*addr=" << hex << *static_cast<unsigned int *>(t._addr) << "}";
+                os << "=>" << pt->log();
+            os << ",pt[" << page(t._addr) << "]=" << pte << ",f=" << pte2phy(pte) << ",*addr=" << hex << *static_cast<unsigned int *>(t._addr) << "}";
             return os;
         }
 
@@ -327,7 +469,7 @@ public:
     };
 
 public:
-    RV32S_MMU() {}
+    SV39_MMU() {}
 
     static Phy_Addr alloc(unsigned int frames = 1, Color color = WHITE) {
         Phy_Addr phy(false);
@@ -382,49 +524,73 @@ public:
 
     static unsigned int allocable(Color color = WHITE) { return _free[color].head() ? _free[color].head()->size() : 0; }
 
-    static Page_Directory * volatile current() { return static_cast<Page_Directory * volatile>(phy2log(CPU::pdp())); }
+    static Page_Directory * volatile current() { return reinterpret_cast<Page_Directory * volatile>(CPU::pdp()); }
 
-    static Phy_Addr physical(Log_Addr addr) {
-        Page_Directory * pd = current();
-        Page_Table * pt = (*pd)[directory(addr)];
-        return (*pt)[page(addr)] | offset(addr);
-    }
+    static Phy_Addr physical(Log_Addr addr) { return walk(current(), addr); }
 
     static PT_Entry phy2pte(Phy_Addr frame, Page_Flags flags) { return (frame >> 2) | flags; }
-    static Phy_Addr pte2phy(PT_Entry entry) { return (entry & ~Page_Flags::MASK) << 2; }
+    static Phy_Addr pte2phy(PT_Entry entry) { return Phy_Addr((entry & ~Page_Flags::MASK) << 2); }
     static PD_Entry phy2pde(Phy_Addr frame) { return (frame >> 2) | Page_Flags::V; }
-    static Phy_Addr pde2phy(PD_Entry entry) { return (entry & ~Page_Flags::MASK) << 2; }
+    static Phy_Addr pde2phy(PD_Entry entry) { return Phy_Addr((entry & ~Page_Flags::MASK) << 2); }
 
-    static void flush_tlb() {
-        //TODO
-    }
-    static void flush_tlb(Log_Addr addr) {
-        //TODO
-    }
+    // Megapages must be aligned to 2 MB and gigapages to 1 GB, otherwise the walk raises a page fault
+    static PD_Entry phy2mpte(Phy_Addr frame, Page_Flags flags) { return phy2pte(frame & ~(MEGA_PAGE_SIZE - 1), flags); }
+    static PT_Entry phy2gpte(Phy_Addr frame, Page_Flags flags) { return phy2pte(frame & ~((1U << GIGA_PAGE_SHIFT) - 1), flags); }
+    static bool leaf(PT_Entry entry) { return entry & Page_Flags::LEAF; }
+
+    static Log_Addr phy2log(Phy_Addr phy) { return Log_Addr((RAM_BASE == PHY_MEM) ? phy : (RAM_BASE > PHY_MEM) ? phy - (RAM_BASE - PHY_MEM) : phy + (PHY_MEM - RAM_BASE)); }
+    static Phy_Addr log2phy(Log_Addr log) { return Phy_Addr((RAM_BASE == PHY_MEM) ? log : (RAM_BASE > PHY_MEM) ? log + (RAM_BASE - PHY_MEM) : log - (PHY_MEM - RAM_BASE)); }
+
+    static void flush_tlb() { CPU::flush_tlb(); }
+    static void flush_tlb(Log_Addr addr) { CPU::flush_tlb(addr); }
 
 private:
     static void init();
 
-    static Log_Addr phy2log(Phy_Addr phy) { return Log_Addr((RAM_BASE == PHY_MEM) ? phy : (RAM_BASE > PHY_MEM) ? phy - (RAM_BASE - PHY_MEM) : phy + (PHY_MEM - RAM_BASE)); }
-
     static Color phy2color(Phy_Addr phy) { return static_cast<Color>(colorful ? ((phy >> PAGE_SHIFT) & 0x7f) % COLORS : WHITE); } // TODO: what is 0x7f
 
     static Color log2color(Log_Addr log) {
         if(colorful) {
-            Page_Directory * pd = current();
-            Page_Table * pt = (*pd)[directory(log)];
-            Phy_Addr phy = (*pt)[page(log)] | offset(log);
+            Phy_Addr phy = physical(log);
             return static_cast<Color>(((phy >> PAGE_SHIFT) & 0x7f) % COLORS);
         } else
             return WHITE;
     }
 
+    // Software page walk, stopping at gigapage and megapage leaves
+    static Phy_Addr walk(Page_Directory * pd, Log_Addr addr) {
+        PT_Entry root = pd->log().root(addr >> GIGA_PAGE_SHIFT);
+        if(leaf(root))
+            return pte2phy(root) | (addr & ((1U << GIGA_PAGE_SHIFT) - 1));
+        PD_Entry pde = pd->log()[directory(addr)];
+        if(leaf(pde))
+            return pte2phy(pde) | (addr & (MEGA_PAGE_SIZE - 1));
+        Page_Table * pt = static_cast<Page_Table *>(pde2phy(pde));
+        return pte2phy(pt->log()[page(addr)]) | offset(addr);
+    }
+
+    // The ASID of a directory found through satp (e.g. the current one)
+    static unsigned int pd2asid(Page_Directory * pd) { return (Phy_Addr(pd) == CPU::pdp()) ? CPU::asid() : 0; }
+
+    static unsigned int asid_alloc() {
+        for(unsigned int i = 1; i < _asids; i++)
+            if(!(_asid_map[i / 32] & (1 << (i % 32)))) {
+                _asid_map[i / 32] |= 1 << (i % 32);
+                return i;
+            }
+        return 0;
+    }
+
+    static void asid_free(unsigned int asid) { _asid_map[asid / 32] &= ~(1 << (asid % 32)); }
+
 private:
     static List _free[colorful * COLORS + 1]; // +1 for WHITE
     static Page_Directory * _master;
+    static unsigned int _asids; // ASIDs implemented by the hart (up to ASIDS), probed at init
+    static unsigned int _asid_map[ASIDS / 32];
 };
 
-class MMU: public IF<Traits<System>::multitask, RV32S_MMU, No_MMU>::Result {};
+class MMU: public IF<Traits<System>::multitask, SV39_MMU, No_MMU>::Result {};
 
 __END_SYS
 
@@ -3,6 +3,7 @@
 #ifndef __cortex_i2c_h
 #define __cortex_i2c_h
 
+#include <machine/ic.h>
 #include <machine/i2c.h>
 #include __HEADER_MMOD(i2c)
 
@@ -13,14 +14,33 @@ class I2C: private I2C_Engine
     friend Machine;
 
 private:
+    static const unsigned int UNITS = Traits<I2C>::UNITS;
+
     typedef I2C_Engine Engine;
 
+    // Transfer state is per unit, shared by all I2C objects of that unit and by the interrupt handler
+    struct Transfer {
+        const Segment * list;
+        unsigned int n;
+        unsigned int segment;
+        unsigned int done;
+        volatile bool busy;
+        volatile bool ok;
+        volatile bool waiting;
+        Semaphore * finished;
+        Callback * callback;
+        void * data;
+    };
+
 public:
     using I2C_Common::MASTER;
     using I2C_Common::SLAVE;
 
+    using I2C_Common::Segment;
+    using I2C_Common::Callback;
+
 public:
-    I2C(unsigned int unit = 0, const Role & role = MASTER): I2C_Engine(unit, role) {}
+    I2C(unsigned int unit = 0, const Role & role = MASTER): I2C_Engine(unit, role), _unit(unit) {}
 
     using Engine::get;
     using Engine::put;
@@ -28,6 +48,13 @@ public:
     using Engine::read;
     using Engine::write;
 
+    // Interrupt-driven transfers (master only): transfer() starts moving a list of segments and returns at once, or
+    // returns false if the unit is still busy. The list must remain valid until completion, which calls
+    // callback(ok, data) from the interrupt handler and releases wait(), which returns whether all bytes were acknowledged.
+    bool transfer(const Segment * list, unsigned int n, Callback * callback = 0, void * data = 0);
+    bool wait();
+    bool done() const { return !_transfers[_unit].busy; }
+
     using Engine::flush;
     using Engine::ready_to_get;
     using Engine::ready_to_put;
@@ -39,6 +66,18 @@ public:
 
 private:
     using Engine::init;
+
+    Transfer & open();
+
+    static void service(unsigned int unit);
+    static void eoi(IC::Interrupt_Id id);
+    static void int_handler(IC::Interrupt_Id id);
+
+private:
+    unsigned int _unit;
+
+    static I2C * _devices[UNITS];
+    static Transfer _transfers[UNITS];
 };
 
 __END_SYS
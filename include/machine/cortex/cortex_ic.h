@@ -22,6 +22,12 @@ private:
 public:
     using Engine::Interrupt_Id;
     using Engine::Interrupt_Handler;
+    using Engine::Priority;
+
+    using Engine::PRIORITY_HIGHEST;
+    using Engine::PRIORITY_HIGH;
+    using Engine::PRIORITY_NORMAL;
+    using Engine::PRIORITY_LOW;
 
     using Engine::INT_SYS_TIMER;
     using Engine::INT_USER_TIMER0;
@@ -33,6 +39,8 @@ public:
     using Engine::INT_GPIOC;
     using Engine::INT_GPIOD;
     using Engine::INT_USB0;
+    using Engine::INT_UART0;
+    using Engine::INT_UART1;
     using Engine::INT_NIC0_RX;
     using Engine::INT_NIC0_TX;
     using Engine::INT_NIC0_ERR;
@@ -54,6 +62,13 @@ public:
         _int_vector[i] = h;
     }
 
+    // Runs before interrupts are re-enabled in dispatch(), so level-triggered devices must be quiesced here
+    static void eoi_vector(Interrupt_Id i, const Interrupt_Handler & h) {
+        db<IC>(TRC) << "IC::eoi_vector(int=" << i << ",h=" << reinterpret_cast<void *>(h) <<")" << endl;
+        assert(i < INTS);
+        _eoi_vector[i] = h;
+    }
+
     static void enable() {
         db<IC>(TRC) << "IC::enable()" << endl;
         Engine::enable();
@@ -74,6 +89,16 @@ public:
         Engine::disable(i);
     }
 
+    static Priority priority(Interrupt_Id i) {
+        assert(i < INTS);
+        return Engine::priority(i);
+    }
+    static void priority(Interrupt_Id i, const Priority & p) {
+        db<IC>(TRC) << "IC::priority(int=" << i << ",p=" << hex << p << ")" << endl;
+        assert(i < INTS);
+        Engine::priority(i, p);
+    }
+
     using Engine::int_id;
     using Engine::irq2int;
     using Engine::int2irq;
@@ -93,6 +118,8 @@ public:
 
 private:
     static void dispatch(unsigned int i);
+    static void handle(unsigned int i);
+    static void switch_stack(unsigned int i, void * stack) __attribute__((naked));
     static void eoi(unsigned int i);
 
     // Logical handlers
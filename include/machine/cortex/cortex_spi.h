@@ -3,6 +3,8 @@
 #ifndef __cortex_spi_h
 #define __cortex_spi_h
 
+#include <architecture/mmu.h>
+#include <machine/ic.h>
 #include <machine/spi.h>
 #include __HEADER_MMOD(spi)
 
@@ -13,11 +15,44 @@ class SPI: private SPI_Engine
     friend Machine;
 
 private:
+    static const unsigned int UNITS = Traits<SPI>::UNITS;
+
     typedef SPI_Engine Engine;
+    typedef CPU::Reg32 Reg32;
+
+    // DMA state is per unit, shared by all SPI objects of that unit and by the interrupt handler
+    struct DMA {
+        MMU::DMA_Buffer * buffer;   // task lists (rx, then tx) and a dummy word
+        DMA_Task * rx;
+        DMA_Task * tx;
+        Reg32 * dummy;
+        volatile bool busy;
+        volatile bool waiting;
+        Semaphore * done;
+        Callback * callback;
+        void * data;
+    };
+
+public:
+    using SPI_Common::Protocol;
+    using SPI_Common::MOTO0;
+    using SPI_Common::MOTO1;
+    using SPI_Common::MOTO2;
+    using SPI_Common::MOTO3;
+    using SPI_Common::TI;
+    using SPI_Common::NMW;
+
+    using SPI_Common::Mode;
+    using SPI_Common::MASTER;
+    using SPI_Common::SLAVE;
+    using SPI_Common::SLAVE_OD;
+
+    using SPI_Common::Segment;
+    using SPI_Common::Callback;
 
 public:
     SPI(unsigned int unit, unsigned int clock, const Protocol & protocol, const Mode & mode, unsigned int bit_rate, unsigned int data_bits)
-    : Engine(unit, clock, protocol, mode, bit_rate, data_bits) {}
+    : Engine(unit, clock, protocol, mode, bit_rate, data_bits), _unit(unit) {}
 
     using Engine::config;
 
@@ -30,14 +65,33 @@ public:
     using Engine::ready_to_get;
     using Engine::ready_to_put;
 
+    // DMA transfers (see Traits<SPI>::dma): transfer() starts shifting a scatter/gather list and returns at once, or
+    // returns false if the unit is still busy or the list is too long. Completion calls callback(data) from the
+    // interrupt handler and releases wait(), so the CPU is free while the data moves.
+    bool transfer(const Segment * list, unsigned int n, Callback * callback = 0, void * data = 0);
+    void wait();
+    bool done() const { return !_dma[_unit].busy; }
+
     using Engine::int_enable;
     using Engine::int_disable;
 
+    using Engine::loopback;
     using Engine::power;
 
 private:
     using Engine::init;
 
+    DMA & open();
+
+    static void eoi(IC::Interrupt_Id id);
+    static void int_handler(IC::Interrupt_Id id);
+    static unsigned int int2unit(IC::Interrupt_Id id);
+
+private:
+    unsigned int _unit;
+
+    static SPI * _devices[UNITS];
+    static DMA _dma[UNITS];
 };
 
 __END_SYS
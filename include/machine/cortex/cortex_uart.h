@@ -4,6 +4,7 @@
 #define __cortex_uart_h
 
 #include <architecture/cpu.h>
+#include <machine/ic.h>
 #include <machine/uart.h>
 #include __HEADER_MMOD(uart)
 
@@ -12,14 +13,31 @@ __BEGIN_SYS
 class UART: private UART_Engine
 {
 private:
+    static const unsigned int UNITS = Traits<UART>::UNITS;
     static const unsigned int UNIT = Traits<UART>::DEF_UNIT;
     static const unsigned int BAUD_RATE = Traits<UART>::DEF_BAUD_RATE;
     static const unsigned int DATA_BITS = Traits<UART>::DEF_DATA_BITS;
     static const unsigned int PARITY = Traits<UART>::DEF_PARITY;
     static const unsigned int STOP_BITS = Traits<UART>::DEF_STOP_BITS;
+    static const unsigned int BUFFER_SIZE = Traits<UART>::BUFFER_SIZE; // must be a power of 2
 
     typedef UART_Engine Engine;
 
+    // Ring buffers are per unit, shared by all UART objects of that unit and by the interrupt handlers
+    struct Buffers {
+        char rx[BUFFER_SIZE];
+        char tx[BUFFER_SIZE];
+        volatile unsigned int rx_head;
+        volatile unsigned int rx_tail;
+        volatile unsigned int tx_head;
+        volatile unsigned int tx_tail;
+        volatile bool rx_waiting;
+        volatile bool tx_waiting;
+        Semaphore * rx_ready;
+        Semaphore * tx_ready;
+        unsigned int overruns;
+    };
+
 public:
     using UART_Common::NONE;
     using UART_Common::EVEN;
@@ -27,30 +45,29 @@ public:
 
 public:
     UART(unsigned int unit = UNIT, unsigned int baud_rate = BAUD_RATE, unsigned int data_bits = DATA_BITS, unsigned int parity = PARITY, unsigned int stop_bits = STOP_BITS)
-    : Engine(unit, baud_rate, data_bits, parity, stop_bits) {}
+    : Engine(unit, baud_rate, data_bits, parity, stop_bits), _unit(unit) {}
 
     using Engine::config;
     using Engine::loopback;
 
+    // Polled I/O, which works with interrupts disabled (e.g. for the Display)
     char get() { while(!rxd_ok()); return rxd(); }
     void put(char c) { while(!txd_ok()); txd(c); }
 
-    int read(char * data, unsigned int max_size){
-        for(unsigned int i=0;i<max_size;i++){
-            data[i]=get();
-        }
-        return 0;
-    }
-    int write(const char * data, unsigned int size){
-        for(unsigned int i=0;i<size;i++){
-            put(data[i]);
-        }
-        return 0;
-    }
-
-    void flush() { while(!txd_empty()); }
-    bool ready_to_get() { return rxd_ok(); }
-    bool ready_to_put() { return txd_ok(); }
+    // Interrupt-driven, buffered I/O: the first call switches the unit to interrupts and, from then on, the calling
+    // thread sleeps while the receive buffer is empty (read) or the transmit buffer is full (write)
+    int read(char * data, unsigned int size);
+    int write(const char * data, unsigned int size);
+
+    // Non-blocking variants, which return the number of bytes actually transferred
+    int try_read(char * data, unsigned int size);
+    int try_write(const char * data, unsigned int size);
+
+    void flush();
+    bool ready_to_get() { return _devices[_unit] ? (_buffers[_unit].rx_tail != _buffers[_unit].rx_head) : rxd_ok(); }
+    bool ready_to_put() { return _devices[_unit] ? (_buffers[_unit].tx_tail - _buffers[_unit].tx_head < BUFFER_SIZE) : txd_ok(); }
+
+    unsigned int overruns() const { return _buffers[_unit].overruns; }
 
     using Engine::int_enable;
     using Engine::int_disable;
@@ -59,6 +76,23 @@ public:
 
 private:
     using Engine::init;
+
+    Buffers & open();
+    void wait_rx();
+    void wait_tx();
+
+    static void service(unsigned int unit);
+    static void eoi(IC::Interrupt_Id id);
+    static void int_handler(IC::Interrupt_Id id);
+
+    static IC::Interrupt_Id unit2int(unsigned int unit) { return unit ? IC::INT_UART1 : IC::INT_UART0; }
+    static unsigned int int2unit(IC::Interrupt_Id id) { return (id == IC::INT_UART1) ? 1 : 0; }
+
+private:
+    unsigned int _unit;
+
+    static UART * _devices[UNITS];
+    static Buffers _buffers[UNITS];
 };
 
 __END_SYS
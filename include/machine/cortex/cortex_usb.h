@@ -6,6 +6,7 @@
 #include <architecture/cpu.h>
 #include <machine/ic.h>
 #include <machine/usb.h>
+#include <utility/buffer.h>
 #include __HEADER_MMOD(usb)
 
 __BEGIN_SYS
@@ -18,8 +19,39 @@ class USB: private USB_Engine
 private:
     typedef USB_Engine Engine;
 
+    static const unsigned int BUFFERS = Traits<USB>::BUFFERS; // per direction
+
+public:
+    static const unsigned int PACKET_SIZE = Engine::PACKET_SIZE;
+
+    // A bulk packet, moved between the endpoint FIFOs and the application without further copies
+    struct Packet {
+        char payload[PACKET_SIZE];
+    };
+
+    typedef _UTIL::Buffer<USB, Packet> Buffer;
+
+private:
+    // Buffer rings, shared by all USB objects and by the interrupt handlers. Buffers go around each ring in order:
+    // rx: [head, next) are held by the application, [next, tail) hold received packets, the rest are free;
+    // tx: [head, tail) hold packets to be sent, [tail, next) are being filled by the application, the rest are free.
+    struct Rings {
+        Buffer * rx[BUFFERS];
+        Buffer * tx[BUFFERS];
+        volatile unsigned int rx_head;
+        volatile unsigned int rx_next;
+        volatile unsigned int rx_tail;
+        volatile unsigned int tx_head;
+        volatile unsigned int tx_next;
+        volatile unsigned int tx_tail;
+        volatile bool rx_waiting;
+        volatile bool tx_waiting;
+        Semaphore * rx_ready;
+        Semaphore * tx_ready;
+    };
+
 public:
-    USB(unsigned int unit) {} // only one USB is supported!
+    USB(unsigned int unit = 0) {} // only one USB is supported!
 
     using Engine::get;
     using Engine::put;
@@ -31,6 +63,20 @@ public:
     using Engine::ready_to_get;
     using Engine::ready_to_put;
 
+    // Packet-level, interrupt-driven I/O on the bulk data endpoints. The first call switches them to interrupts and,
+    // from then on, the OUT endpoint belongs to the receive ring (get() and read() will no longer see its data).
+    // receive() hands out the next received packet (its size() tells how many bytes it holds) and release() gives it
+    // back; alloc() hands out an empty packet and send() queues it after the application has filled it and set its
+    // size. Buffers must be released (or sent) in the order they were handed out. The blocking calls sleep while the
+    // corresponding ring is empty (receive) or full (alloc); the try_ variants return 0 instead.
+    Buffer * receive();
+    Buffer * try_receive();
+    void release(Buffer * buf);
+
+    Buffer * alloc();
+    Buffer * try_alloc();
+    void send(Buffer * buf);
+
     using Engine::int_enable;
     using Engine::int_disable;
     using Engine::power;
@@ -43,8 +89,15 @@ private:
         IC::enable(IC::INT_USB0);
     }
 
+    Rings & open();
+
+    static void service();
     static void int_handler(IC::Interrupt_Id i);
     static void eoi(IC::Interrupt_Id int_id);
+
+private:
+    static USB * _device;
+    static Rings _rings;
 };
 
 __END_SYS
@@ -10,6 +10,7 @@
 #define __i2c_common_only__
 #include <machine/i2c.h>
 #undef __i2c_common_only__
+#include <machine/ic.h>
 #include "emote3_sysctrl.h"
 #include "emote3_ioctrl.h"
 #include <system/memory_map.h>
@@ -212,6 +213,18 @@ public:
     bool ready_to_get() { return ready_to_put(); }
     bool ready_to_put() { return !(i2c(I2C_STAT) & I2C_STAT_BUSY); }
 
+    // Non-blocking primitives for interrupt-driven transfers (master only)
+    void address(unsigned char slave_address, bool read) { i2c(I2C_SA) = (slave_address << 1) | (read ? I2C_SA_RS : 0); }
+    void command(Reg32 ctrl) { i2c(I2C_CTRL) = ctrl; }
+    void data(char c) { i2c(I2C_DR) = c; }
+    char data() { return i2c(I2C_DR); }
+    Reg32 status() { return i2c(I2C_STAT); }
+
+    void master_int_enable() { i2c(I2C_IMR) = I2C_IMR_IM; }
+    void master_int_disable() { i2c(I2C_IMR) = 0; }
+    bool master_int() { return i2c(I2C_MIS) & I2C_MIS_MIS; }
+    void master_int_clear() { i2c(I2C_ICR) = I2C_ICR_IC; }
+
 private:
     bool put_byte(char data, int mode) {
         // assumes that slave address already written to I2CMSA
@@ -311,6 +324,61 @@ public:
 
     static void init() {}
 
+protected:
+    // Interrupt-driven transfers (master only). begin() issues a (repeated) start for a segment and its first byte;
+    // step(), called on each master interrupt, completes the byte in flight and issues the next one. step() returns the
+    // number of bytes of the segment transferred so far, or -1 if the slave did not acknowledge (a stop is then sent).
+    void begin(const Segment & s, bool last) {
+        _i2c->address(s.address, s.read);
+        if(s.read)
+            _i2c->command(I2C_CTRL_START | I2C_CTRL_RUN | ((s.size > 1) ? I2C_CTRL_ACK : (last ? I2C_CTRL_STOP : 0)));
+        else {
+            _i2c->data(s.data[0]);
+            _i2c->command(I2C_CTRL_START | I2C_CTRL_RUN | (((s.size == 1) && last) ? I2C_CTRL_STOP : 0));
+        }
+    }
+
+    int step(const Segment & s, unsigned int done, bool last) {
+        CPU::Reg32 status = _i2c->status();
+        if(status & I2C_STAT_ERROR) {
+            if(!(status & I2C_STAT_ARBLST))
+                _i2c->command(I2C_CTRL_STOP);
+            return -1;
+        }
+
+        if(s.read)
+            s.data[done] = _i2c->data();
+        done++;
+
+        if(done < s.size) {
+            bool final = (done + 1 == s.size);
+            if(s.read)
+                _i2c->command(I2C_CTRL_RUN | (!final ? I2C_CTRL_ACK : (last ? I2C_CTRL_STOP : 0)));
+            else {
+                _i2c->data(s.data[done]);
+                _i2c->command(I2C_CTRL_RUN | ((final && last) ? I2C_CTRL_STOP : 0));
+            }
+        }
+
+        return done;
+    }
+
+    bool int_pending() {
+        bool pending = _i2c->master_int();
+        if(pending)
+            _i2c->master_int_clear();
+        return pending;
+    }
+
+    void int_master(bool on) {
+        if(on)
+            _i2c->master_int_enable();
+        else
+            _i2c->master_int_disable();
+    }
+
+    static IC::Interrupt_Id interrupt() { return IC::irq2int(NVIC::IRQ_I2C); }
+
 private:
     static SysCtrl * scr() { return reinterpret_cast<SysCtrl *>(Memory_Map::SCR_BASE); }
     static IOCtrl * ioc() { return reinterpret_cast<IOCtrl *>(Memory_Map::IOC_BASE); }
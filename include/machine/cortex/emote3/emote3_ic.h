@@ -33,6 +33,8 @@ public:
         INT_NIC0_ERR    = HARD_INT + NVIC::IRQ_RFERR,
         INT_NIC0_TIMER  = HARD_INT + NVIC::IRQ_MACTIMER,
         INT_USB0        = HARD_INT + NVIC::IRQ_USB,
+        INT_UART0       = HARD_INT + NVIC::IRQ_UART0,
+        INT_UART1       = HARD_INT + NVIC::IRQ_UART1,
         INT_LAST_HARD   = HARD_INT + NVIC::IRQS,
         INT_RESCHEDULER = SOFT_INT,
         LAST_INT        = INT_RESCHEDULER
@@ -44,6 +46,9 @@ public:
     static void disable() { nvic()->disable(); }
     static void disable(Interrupt_Id id) { nvic()->disable(id); }
 
+    static Priority priority(Interrupt_Id id) { return nvic()->priority(id); }
+    static void priority(Interrupt_Id id, const Priority & p) { nvic()->priority(id, p); }
+
     // Only works in handler mode (inside IC::entry())
     static Interrupt_Id int_id() { return CPU::flags() & 0x3f; }
     static Interrupt_Id irq2int(Interrupt_Id id) { return nvic()->irq2int(id); }
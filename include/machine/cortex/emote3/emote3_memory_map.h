@@ -33,6 +33,7 @@ struct Memory_Map: public Cortex_Memory_Map
         GPIOB_BASE      = 0x400da000, // PL061 GPIO Port B
         GPIOC_BASE      = 0x400db000, // PL061 GPIO Port C
         GPIOD_BASE      = 0x400dc000, // PL061 GPIO Port D
+        UDMA_BASE       = 0x400ff000, // uDMA controller
         CCTEST_BASE     = 0x44010000,
         SCB_BASE        = 0xe000e000, // System Control Block
         VECTOR_TABLE    = Traits<Machine>::APP_CODE,
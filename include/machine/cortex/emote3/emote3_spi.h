@@ -7,6 +7,8 @@
 #include <machine/spi.h>
 #include <machine/cortex/engine/pl022.h>
 #include <machine/cortex/engine/pl061.h>
+#include <machine/cortex/engine/cortex_m3/udma.h>
+#include <machine/ic.h>
 #include "emote3_sysctrl.h"
 #include "emote3_ioctrl.h"
 #include <system/memory_map.h>
@@ -20,6 +22,11 @@ private:
 
     typedef CPU::Reg32 Reg32;
 
+protected:
+    static const unsigned int DMA_TASKS = Traits<SPI>::DMA_TASKS;
+
+    typedef UDMA::Control DMA_Task;
+
 public:
     SPI_Engine(unsigned int unit, unsigned int clock, const Protocol & protocol, const Mode & mode, unsigned int bit_rate, unsigned int data_bits): _unit(unit) {
         assert(unit < UNITS);
@@ -58,6 +65,59 @@ public:
         int_enable(!receive, !transmit, !time_out, !overrun);
     }
 
+    void loopback(bool on = true) { _pl022->loopback(on); }
+
+protected:
+    // Programs the receive and transmit uDMA channels in peripheral scatter/gather mode, with one task per direction
+    // for every MAX_TRANSFER bytes of each segment. Null buffers are replaced by dummy, which must hold a zero.
+    // Assumes frames of up to 8 bits. Returns false if the list takes more than DMA_TASKS tasks.
+    bool dma_start(const Segment * list, unsigned int n, DMA_Task * rx, DMA_Task * tx, Reg32 * dummy) {
+        unsigned int tasks = 0;
+        for(unsigned int i = 0; i < n; i++)
+            tasks += (list[i].size + UDMA::MAX_TRANSFER - 1) / UDMA::MAX_TRANSFER;
+        if(!tasks || (tasks > DMA_TASKS))
+            return false;
+
+        volatile Reg32 * dr = _pl022->data();
+        unsigned int t = 0;
+        for(unsigned int i = 0; i < n; i++) {
+            const char * out = reinterpret_cast<const char *>(list[i].tx);
+            char * in = reinterpret_cast<char *>(list[i].rx);
+            for(unsigned int done = 0; done < list[i].size; t++) {
+                unsigned int count = list[i].size - done;
+                if(count > UDMA::MAX_TRANSFER)
+                    count = UDMA::MAX_TRANSFER;
+                bool last = (t == tasks - 1);
+                rx[t] = UDMA::task(dr, false, in ? static_cast<volatile void *>(in + done) : static_cast<volatile void *>(dummy), in != 0, count, last);
+                tx[t] = UDMA::task(out ? static_cast<const volatile void *>(out + done) : static_cast<const volatile void *>(dummy), out != 0, dr, false, count, last);
+                done += count;
+            }
+        }
+
+        Reg32 stale;
+        while(_pl022->try_get(&stale));
+
+        udma()->scatter_gather(rx_channel(), rx, tasks);
+        udma()->scatter_gather(tx_channel(), tx, tasks);
+        _pl022->dma_enable(true, true);
+
+        return true;
+    }
+
+    // Checks for (and acknowledges) the end of a transfer. Reception always ends last.
+    bool dma_done() {
+        if(!udma()->done(rx_channel()))
+            return false;
+
+        udma()->clear(rx_channel());
+        udma()->clear(tx_channel());
+        _pl022->dma_disable();
+        return true;
+    }
+
+    IC::Interrupt_Id dma_interrupt() const { return IC::irq2int(_unit ? NVIC::IRQ_SSI1 : NVIC::IRQ_SSI0); }
+
+public:
     void power(const Power_Mode & mode) {
         switch(mode) {
         case ENROLL:
@@ -79,15 +139,25 @@ public:
         }
     }
 
-    static void init() {}
+    static void init() {
+        if(Traits<SPI>::dma)
+            udma()->init(_dma_table);
+    }
 
 private:
     static SysCtrl * scr() { return reinterpret_cast<SysCtrl *>(Memory_Map::SCR_BASE); }
     static IOCtrl * ioc() { return reinterpret_cast<IOCtrl *>(Memory_Map::IOC_BASE); }
+    static UDMA * udma() { return reinterpret_cast<UDMA *>(Memory_Map::UDMA_BASE); }
+
+    // uDMA channels (encoding 0) of SSI0 are 10 (RX) and 11 (TX), those of SSI1 are 24 and 25
+    unsigned int rx_channel() const { return _unit ? 24 : 10; }
+    unsigned int tx_channel() const { return rx_channel() + 1; }
 
 private:
     unsigned int _unit;
     PL022 * _pl022;
+
+    static DMA_Task _dma_table[Traits<SPI>::dma ? 2 * UDMA::CHANNELS : 1];
 };
 
 __END_SYS
@@ -86,6 +86,8 @@ template<> struct Traits<UART>: public Traits<Machine_Common>
     static const unsigned int DEF_PARITY = 0; // none
     static const unsigned int DEF_STOP_BITS = 1;
 
+    static const unsigned int BUFFER_SIZE = 256; // per direction, for interrupt-driven read() and write()
+
     static const unsigned int CM1101_UNIT = 0;
 };
 
@@ -116,6 +118,10 @@ template<> struct Traits<I2C>::Config<0>
 template<> struct Traits<SPI>: public Traits<Machine_Common>
 {
     static const unsigned int UNITS = 1;
+
+    // Scatter/gather transfers through the uDMA controller
+    static const bool dma = true;
+    static const unsigned int DMA_TASKS = 16;   // per direction; segments longer than 1 KB take several tasks
 };
 
 template<> struct Traits<USB>: public Traits<Machine_Common>
@@ -127,6 +133,7 @@ template<> struct Traits<USB>: public Traits<Machine_Common>
     static const bool wait_to_sync = true;
     static const unsigned int UNITS = 1;
     static const bool blocking = false;
+    static const unsigned int BUFFERS = 8;      // packets per direction for packet-level I/O
     static const bool enabled = true;
 };
 
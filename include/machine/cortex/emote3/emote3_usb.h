@@ -28,6 +28,9 @@ public:
     static const unsigned int _max_packet_ep4 = 256;
     static const unsigned int _max_packet_ep5 = 512;
 
+    // Packet size of the bulk data endpoints (the full-speed maximum), which are double-buffered in their FIFOs
+    static const unsigned int PACKET_SIZE = 64;
+
     // Registers offsets from BASE (i.e. this)
     enum {
     //  Name        Offset   Type  Width   Reset Value    Physical Address
@@ -162,6 +165,16 @@ public:
         INDBLBUF     = 1 << 0, // IN endpoint FIFO double-buffering enable.                              RW 0
     };
 
+    // Useful bits in CSOH
+    enum {
+      //Name           Offset     Description                                                          Type Reset
+        AUTOCLEAR    = 1 << 7, // If set by software, the CSOL.OUTPKTRDY bit is automatically cleared    RW 0
+                               // when a packet of maximum size (specified by USBMAXO) has been
+                               // unloaded from the OUT FIFO.
+        OUTISO       = 1 << 6, // Selects OUT endpoint type: 0: Bulk/interrupt 1: Isochronous            RW 0
+        OUTDBLBUF    = 1 << 0, // OUT endpoint FIFO double-buffering enable.                             RW 0
+    };
+
     // Useful bits in CSIL
     enum {
       //Name              Offset     Description                                                         Type Reset
@@ -217,6 +230,45 @@ public:
 
     void reset();
 
+    // Packet-level access to the bulk data endpoints, for the interrupt-driven mediator (called with interrupts
+    // disabled). Each call moves a whole packet between memory and the endpoint FIFO.
+    bool rx_packet_ok() {
+        input();
+        return usb(CSOL) & CSOL_OUTPKTRDY;
+    }
+
+    unsigned int rx_packet(char * data) {
+        input();
+        unsigned int size = (usb(CNTH) << 8) | usb(CNT0_CNTL);
+        if(size > PACKET_SIZE)
+            size = PACKET_SIZE;
+        for(unsigned int i = 0; i < size; i++)
+            data[i] = usb(F4);
+        usb(CSOL) &= ~CSOL_OUTPKTRDY; // with double-buffering, the next packet (if any) becomes visible right away
+        return size;
+    }
+
+    bool tx_packet_ok() {
+        if(!_ready_to_put)
+            return false;
+        output();
+        return !(usb(CS0_CSIL) & CSIL_INPKTRDY); // with double-buffering, only set while both FIFOs are loaded
+    }
+
+    void tx_packet(const char * data, unsigned int size) {
+        output();
+        for(unsigned int i = 0; i < size; i++)
+            usb(F3) = data[i];
+        flush();
+    }
+
+    // Enables the data endpoint interrupts (IN on endpoint 3, OUT on endpoint 4), which survive bus resets
+    void packet_int_enable() {
+        _packet_ints = true;
+        usb(IIE) |= (1 << 3);
+        usb(OIE) |= (1 << 4);
+    }
+
     void eoi() {
         // USB interrupt flags are cleared when read
         _cif |= usb(CIF);
@@ -254,12 +306,14 @@ public:
 
     void init();
 
+protected:
+    void endpoint(int index) { usb(INDEX) = index; }
+    int endpoint() { return usb(INDEX); }
+
 private:
     bool configured() { return state() >= USB_2_0::STATE::CONFIGURED; }
     USB_2_0::STATE state() { return _state; }
 
-    void endpoint(int index) { usb(INDEX) = index; }
-    int endpoint() { return usb(INDEX); }
     void control() { endpoint(0); }
     void output() { endpoint(3); }
     void input() { endpoint(4); }
@@ -288,6 +342,7 @@ private:
     static volatile bool _ready_to_put; // TODO: isn't it the wrong semantics?
     static volatile bool _ready_to_put_next;
     static volatile bool _locked;
+    static volatile bool _packet_ints;
     static volatile USB_2_0::STATE _state;
     static const Full_Config _config;
 
@@ -110,6 +110,10 @@ public:
         irq(DISABLE_IRQS_1 + (i / 32) * 4) |= 1 << (i % 32);
     }
 
+    // Bulk (un)masking of the interrupts in a bank (0: GPU IRQs 0-31, 1: GPU IRQs 32-63, 2: basic IRQs)
+    void enable(unsigned int bank, Reg32 mask) { irq(ENABLE_IRQS_1 + bank * 4) = mask; }
+    void disable(unsigned int bank, Reg32 mask) { irq(DISABLE_IRQS_1 + bank * 4) = mask; }
+
     Interrupt_Id int_id() {
         Reg32 pending = irq(IRQ_BASIC_PENDING);
         if(pending) {
@@ -220,6 +224,12 @@ public:
             return LAST_INT;
     }
 
+    // Secondary cores are parked by the boot firmware polling their mailbox 3 for an entry point
+    void start(unsigned int cpu, Reg32 entry) {
+        mailbox(MBOX_WS + 16 * cpu + 12) = entry;
+        ASM("dsb \t\n sev");
+    }
+
     void ipi(unsigned int cpu, Interrupt_Id id) {
         mailbox(MBOX_WS + 16 * cpu) = 1 << 31;
     }
@@ -78,8 +78,9 @@ public:
         // LBE             = 1 <<  7,      // Loop Back Enable                      r/w     0
         RXEN            = 1 <<  0,      // Receiver Enable                          r/w     1
         TXEN            = 1 <<  1,      // Transmitter Enable                       r/w     1
-        TX_INT_ENABLE   = 1 <<  0,      // Enable Transmit interrupt, if DLAB=0     ro      0
-        RX_INT_ENABLE   = 1 <<  1,      // Enable Receive interrupt, if DLAB=0      ro      0
+        RX_INT_ENABLE   = 1 <<  0,      // Enable Receive interrupt, if DLAB=0      r/w     0 (swapped with TX in the manual, see errata)
+        TX_INT_ENABLE   = 1 <<  1,      // Enable Transmit interrupt, if DLAB=0     r/w     0
+        INT_LINE_ENABLE = 3 <<  2,      // Required for any interrupt to be issued  r/w     0 (see errata)
         GPIO_PIN_14     = 7 << 12,      // Maps TXD to GPIO_PIN_14                  r/w     0
         GPIO_PIN_15     = 7 << 15,      // Maps TXD to GPIO_PIN_15                  r/w     0
         ALT_FUNC_5_PIN14= 2 << 12,      // Defines GPIO Mapping according to ALT 5  r/w     0
@@ -140,7 +141,7 @@ public:
     void disable() { uart(AUX_ENABLES) &= ~UEN; }
 
     void int_enable(bool receive = true, bool transmit = true, bool line = true, bool modem = true) {
-        uart(AUX_MU_IER_REG) &= ((receive ? RX_INT_ENABLE : 0) | (transmit ? TX_INT_ENABLE : 0));
+        uart(AUX_MU_IER_REG) |= INT_LINE_ENABLE | (receive ? RX_INT_ENABLE : 0) | (transmit ? TX_INT_ENABLE : 0);
     }
     void int_disable(bool receive = true, bool transmit = true, bool line = true, bool modem = true) {
         uart(AUX_MU_IER_REG) &= ~((receive ? RX_INT_ENABLE : 0) | (transmit ? TX_INT_ENABLE : 0));
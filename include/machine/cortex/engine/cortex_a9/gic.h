@@ -120,6 +120,9 @@ public:
         ICCEOIR                     = 0x010     // End Of Interrupt             w/o     -
     };
 
+    // ICCPMR value that lets all implemented priorities through
+    static const Priority UNMASKED = 0xf0;
+
     // Useful bits in ICCICR
     enum {                                      // Description                  Type    Value after reset
         ITF_EN_S                    = 1 << 0,   // Enable secure signaling      r/w     0
@@ -138,6 +141,7 @@ public:
         ICDICER1                    = 0x184,    // Interrupt Clear-Enable       r/w     0x00000000
         ICDICER2                    = 0x188,    // Interrupt Clear-Enable       r/w     0x00000000
         ICDICERn                    = 0x19c,    // Interrupt Clear-Enable       r/w     0x00000000
+        ICDIPR0                     = 0x400,    // Interrupt Priority (1 byte)  r/w     0x00000000
         ICDSGIR                     = 0xf00     // Software Generated Interrupt
     };
 
@@ -174,6 +178,10 @@ public:
         gic_dist(ICDICER0 + (id / 32) * 4) = 1 << (id % 32);
     }
 
+    // ICDIPRn are byte-accessible; unimplemented low-order bits read as zero
+    Priority priority(Interrupt_Id id) { return reinterpret_cast<volatile Priority *>(this)[ICDIPR0 + id]; }
+    void priority(Interrupt_Id id, const Priority & p) { reinterpret_cast<volatile Priority *>(this)[ICDIPR0 + id] = p; }
+
     int irq2int(int i) { return i; }
     int int2irq(int i) { return i; }
 
@@ -209,6 +217,10 @@ public:
     }
 
     void init() {
+        // Reset values give every interrupt the highest priority, which would prevent all nesting
+        for(IRQ i = 0; i <= IRQ_PARITY; i++)
+            priority(i, PRIORITY_NORMAL);
+
         // Enable distributor
         gic_dist(ICDDCR) = DIST_EN_S;
     }
@@ -237,9 +249,13 @@ public:
         return icciar;
     }
 
+    // Only interrupts with priorities strictly lower (i.e. more urgent) than the mask are signaled to the processor
+    Priority mask() { return gic_cpu(ICCPMR); }
+    void mask(const Priority & p) { gic_cpu(ICCPMR) = p; }
+
     void init() {
         // Mask no interrupts
-        gic_cpu(ICCPMR) = 0xf0;
+        mask(UNMASKED);
 
         // Enable interrupts signaling by the CPU interfaces to the connected processors
         gic_cpu(ICCICR) = ACK_CTL | ITF_EN_NS | ITF_EN_S;
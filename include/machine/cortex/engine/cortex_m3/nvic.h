@@ -77,6 +77,7 @@ public:
         IRQ_ACTIVE0     = 0x300,        // Interrupt  0-31 Active Bit                           R/W     0x00000000
         IRQ_ACTIVE1     = 0x304,        // Interrupt 32-63 Active Bit                           R/W     0x00000000
         IRQ_ACTIVE2     = 0x308,        // Interrupt 64-95 Active Bit                           R/W     0x00000000
+        IRQ_PRIORITY0   = 0x400,        // Interrupt Priority (1 byte per IRQ, 3 MSBs used)     R/W     0x00000000
         SWTRIG          = 0xf00         // Software Trigger Interrupt Register                  WO      0x00000000
     };
 
@@ -114,6 +115,18 @@ public:
         }
     }
 
+    // Exceptions (ids below HARD_INT) keep their fixed or reset priorities
+    Priority priority(Interrupt_Id id) {
+        return (id >= HARD_INT) ? reinterpret_cast<volatile Priority *>(this)[IRQ_PRIORITY0 + int2irq(id)] : PRIORITY_HIGHEST;
+    }
+
+    void priority(Interrupt_Id id, const Priority & p) {
+        if(id >= HARD_INT) {
+            assert(static_cast<unsigned int>(int2irq(id)) < IRQS);
+            reinterpret_cast<volatile Priority *>(this)[IRQ_PRIORITY0 + int2irq(id)] = p;
+        }
+    }
+
     int irq2int(int i) const { return i + HARD_INT; }
     int int2irq(int i) const { return i - HARD_INT; }
 
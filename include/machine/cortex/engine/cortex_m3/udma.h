@@ -0,0 +1,153 @@
+// EPOS ARM Cortex-M3 uDMA Controller Mediator Declarations
+
+#ifndef __cortex_m3_udma_h
+#define __cortex_m3_udma_h
+
+#include <architecture/cpu.h>
+
+__BEGIN_SYS
+
+// Micro Direct Memory Access controller (ARM PL230-based, as in TI's CC2538 and Stellaris)
+class UDMA
+{
+    // This is a hardware object.
+    // Use with something like "new (Memory_Map::UDMA_BASE) UDMA".
+
+private:
+    typedef CPU::Reg32 Reg32;
+
+public:
+    static const unsigned int CHANNELS = 32;
+    static const unsigned int MAX_TRANSFER = 1024;      // items per control structure (or task)
+
+    // Registers offsets from BASE (i.e. this)
+    enum {                              // Description                                  Type    Value after reset
+        STAT            = 0x000,        // Status                                       RO      0x001f0000
+        CFG             = 0x004,        // Configuration                                WO      -
+        CTLBASE         = 0x008,        // Channel Control Base Pointer                 RW      0x00000000
+        ALTBASE         = 0x00c,        // Alternate Channel Control Base Pointer       RO      0x00000200
+        WAITSTAT        = 0x010,        // Channel Wait-on-Request Status               RO      0x03c3cf00
+        SWREQ           = 0x014,        // Channel Software Request                     WO      -
+        USEBURSTSET     = 0x018,        // Channel Useburst Set                         RW      0x00000000
+        USEBURSTCLR     = 0x01c,        // Channel Useburst Clear                       WO      -
+        REQMASKSET      = 0x020,        // Channel Request Mask Set                     RW      0x00000000
+        REQMASKCLR      = 0x024,        // Channel Request Mask Clear                   WO      -
+        ENASET          = 0x028,        // Channel Enable Set                           RW      0x00000000
+        ENACLR          = 0x02c,        // Channel Enable Clear                         WO      -
+        ALTSET          = 0x030,        // Channel Primary Alternate Set                RW      0x00000000
+        ALTCLR          = 0x034,        // Channel Primary Alternate Clear              WO      -
+        PRIOSET         = 0x038,        // Channel Priority Set                         RW      0x00000000
+        PRIOCLR         = 0x03c,        // Channel Priority Clear                       WO      -
+        ERRCLR          = 0x04c,        // Bus Error Clear                              RW      0x00000000
+        CHASGN          = 0x500,        // Channel Assignment                           RW      0x00000000
+        CHIS            = 0x504,        // Channel Interrupt Status                     RW1C    0x00000000
+        CHMAP0          = 0x510         // Channel Map Select 0 (4 bits per channel)    RW      0x00000000
+    };
+
+    // Useful bits in CFG
+    enum {
+        MASTEN          = 1 << 0        // Controller master enable
+    };
+
+    // Fields of the control word of a control structure
+    enum {
+        DSTINC          = 30,           // Destination address increment
+        DSTSIZE         = 28,           // Destination data size
+        SRCINC          = 26,           // Source address increment
+        SRCSIZE         = 24,           // Source data size
+        ARBSIZE         = 14,           // Arbitration size (2^ARBSIZE items)
+        XFERSIZE        = 4,            // Transfer size (items - 1)
+        NXTUSEBURST     = 3,            // Next useburst
+        XFERMODE        = 0             // Transfer mode
+    };
+
+    // Data sizes and address increments
+    enum {
+        BYTE            = 0,
+        HALF_WORD       = 1,
+        WORD            = 2,
+        NONE            = 3             // increment only
+    };
+
+    // Transfer modes
+    enum {
+        STOP            = 0,
+        BASIC           = 1,
+        AUTO            = 2,
+        PING_PONG       = 3,
+        MEMORY_SG       = 4,
+        MEMORY_SG_ALT   = 5,
+        PERIPHERAL_SG   = 6,
+        PERIPHERAL_SG_ALT = 7
+    };
+
+    // Channel control structure, also used as a scatter/gather task. Pointers refer to the last item to be transferred.
+    struct Control {
+        volatile Reg32 src_end;
+        volatile Reg32 dst_end;
+        volatile Reg32 control;
+        volatile Reg32 unused;
+    };
+
+public:
+    // Builds a task that moves count bytes between a peripheral data register and memory (or between the register and
+    // a single, non-incremented word when the memory side is just a source of zeros or a sink); the last task of a
+    // list must be built with last = true so the channel stops and raises the done interrupt.
+    static Control task(const volatile void * src, bool src_inc, volatile void * dst, bool dst_inc, unsigned int count, bool last) {
+        assert(count && (count <= MAX_TRANSFER));
+        Control c;
+        c.src_end = reinterpret_cast<Reg32>(src) + (src_inc ? count - 1 : 0);
+        c.dst_end = reinterpret_cast<Reg32>(dst) + (dst_inc ? count - 1 : 0);
+        c.control = ((dst_inc ? BYTE : NONE) << DSTINC) | (BYTE << DSTSIZE) | ((src_inc ? BYTE : NONE) << SRCINC) | (BYTE << SRCSIZE)
+                  | (2 << ARBSIZE) | ((count - 1) << XFERSIZE) | (last ? BASIC : PERIPHERAL_SG_ALT);
+        c.unused = 0;
+        return c;
+    }
+
+    // The control table must be aligned on 1024 bytes and hold the primary and alternate structures of all channels
+    void init(Control * table) {
+        assert(!(reinterpret_cast<Reg32>(table) & 1023));
+        udma(CFG) = MASTEN;
+        udma(CTLBASE) = reinterpret_cast<Reg32>(table);
+    }
+
+    // Peripheral scatter/gather: the primary structure copies each of the n tasks into the alternate one, which then
+    // performs it when requested by the peripheral
+    void scatter_gather(unsigned int channel, Control * tasks, unsigned int n) {
+        assert((channel < CHANNELS) && n && (n * 4 <= MAX_TRANSFER));
+        Control * primary = &table()[channel];
+        Control * alternate = &table()[CHANNELS + channel];
+        primary->src_end = reinterpret_cast<Reg32>(&tasks[n]) - sizeof(Reg32);
+        primary->dst_end = reinterpret_cast<Reg32>(&alternate->unused);
+        primary->control = (WORD << DSTINC) | (WORD << DSTSIZE) | (WORD << SRCINC) | (WORD << SRCSIZE)
+                         | (2 << ARBSIZE) | ((n * 4 - 1) << XFERSIZE) | PERIPHERAL_SG;
+
+        const Reg32 bit = 1 << channel;
+        udma(CHMAP0 + (channel / 8) * 4) &= ~(0xf << ((channel % 8) * 4)); // encoding 0
+        udma(USEBURSTCLR) = bit;
+        udma(REQMASKCLR) = bit;
+        udma(ALTCLR) = bit;
+        udma(PRIOCLR) = bit;
+        udma(CHIS) = bit;
+        udma(ENASET) = bit;
+    }
+
+    void disable(unsigned int channel) { udma(ENACLR) = 1 << channel; }
+    bool enabled(unsigned int channel) { return udma(ENASET) & (1 << channel); }
+
+    // Done flags, which are signaled on the interrupt line of the peripheral that owns the channel
+    bool done(unsigned int channel) { return udma(CHIS) & (1 << channel); }
+    void clear(unsigned int channel) { udma(CHIS) = 1 << channel; }
+
+    bool error() { return udma(ERRCLR); }
+    void clear_error() { udma(ERRCLR) = 1; }
+
+private:
+    Control * table() { return reinterpret_cast<Control *>(udma(CTLBASE)); }
+
+    volatile Reg32 & udma(unsigned int o) { return reinterpret_cast<volatile Reg32 *>(this)[o / sizeof(Reg32)]; }
+};
+
+__END_SYS
+
+#endif
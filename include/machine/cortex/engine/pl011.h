@@ -141,10 +141,10 @@ public:
     void disable() { uart(UCR) &= ~UEN; }
 
     void int_enable(bool receive = true, bool transmit = true, bool line = true, bool modem = true) {
-        uart(UIM) &= ~((receive ? UIMRX : 0) | (transmit ? UIMTX : 0));
+        uart(UIM) |= (receive ? UIMRX | UIMRT : 0) | (transmit ? UIMTX : 0);
     }
     void int_disable(bool receive = true, bool transmit = true, bool line = true, bool modem = true) {
-        uart(UCR) |= (receive ? UIMRX : 0) | (transmit ? UIMTX : 0);
+        uart(UIM) &= ~((receive ? UIMRX | UIMRT : 0) | (transmit ? UIMTX : 0));
     }
 
     void reset() {
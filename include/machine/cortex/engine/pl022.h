@@ -266,6 +266,19 @@ public:
         return false;
     }
 
+    // Requests to the uDMA controller (see TXDMAE and RXDMAE above)
+    void dma_enable(bool receive, bool transmit) { ssi(DMACTL) = (receive ? RXDMAE : 0) | (transmit ? TXDMAE : 0); }
+    void dma_disable() { ssi(DMACTL) = 0; }
+
+    volatile Reg32 * data() { return &ssi(DR); }
+
+    void loopback(bool on) {
+        if(on)
+            ssi(CR1) |= LBM;
+        else
+            ssi(CR1) &= ~LBM;
+    }
+
     bool busy() { return (ssi(SR) & BSY); }
     bool ready_to_get() { return (ssi(SR) & RNE); }
     bool ready_to_put() { return (ssi(SR) & TNF); }
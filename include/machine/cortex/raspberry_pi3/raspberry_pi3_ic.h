@@ -31,6 +31,13 @@ public:
         LAST_INT                = BCM_IC_Common::LAST_INT
     };
 
+    // The BCM2835 controller has no priorities, so they are emulated by IC::handle() by disabling the enabled
+    // interrupts that must not preempt the running handler. Only the BANKS of GPU and basic interrupts can be masked
+    // this way; mailboxes and core-local interrupts (e.g. IPIs and the simulated system timer) are always the most urgent.
+    // Priorities are quantized to LEVELS, i.e. only the 3 most significant bits are implemented.
+    static const unsigned int BANKS = 3;
+    static const unsigned int LEVELS = 8;
+
 public:
     static void enable() {
         mbox()->enable();
@@ -41,7 +48,7 @@ public:
         switch(i / 32){
         case 0 /* */:
         case 1 /* */:
-        case 2 /* IRQ */:       irq()->enable(i);         break;
+        case 2 /* IRQ */:       _enabled[i / 32] |= 1 << (i % 32); irq()->enable(i); break;
         default /* Mailbox */:  mbox()->enable(i);        break;
         }
     }
@@ -55,11 +62,51 @@ public:
         switch(i / 32){
         case 0 /* */:
         case 1 /* */:
-        case 2 /* IRQ */:       irq()->disable(i);        break;
+        case 2 /* IRQ */:       _enabled[i / 32] &= ~(1 << (i % 32)); irq()->disable(i); break;
         default /* Mailbox */:  mbox()->disable(i);       break;
         }
     }
 
+    static Priority priority(Interrupt_Id i) {
+        return (i < BANKS * 32) ? _priority[i] : PRIORITY_HIGHEST;
+    }
+
+    static void priority(Interrupt_Id i, const Priority & p) {
+        if(i >= BANKS * 32)
+            return;
+
+        Reg32 bit = 1 << (i % 32);
+        _level[level(_priority[i])][i / 32] &= ~bit;
+        _level[level(p)][i / 32] |= bit;
+        _priority[i] = p;
+    }
+
+    // Disables the enabled interrupts whose priorities are not more urgent than p and returns in masked[] only those
+    // this call disabled, so the unmask() of a nested handler does not re-enable lines an outer handler still masks
+    static void mask(const Priority & p, Reg32 masked[BANKS]) {
+        Reg32 * current = _masked[CPU::id()];
+        for(unsigned int b = 0; b < BANKS; b++) {
+            Reg32 m = 0;
+            for(unsigned int l = level(p); l < LEVELS; l++)
+                m |= _level[l][b];
+            masked[b] = m & _enabled[b] & ~current[b];
+            if(masked[b]) {
+                current[b] |= masked[b];
+                irq()->disable(b, masked[b]);
+            }
+        }
+    }
+
+    // Re-enables the interrupts disabled by mask(), except those disabled meanwhile (e.g. by an IRQ_Thread)
+    static void unmask(const Reg32 masked[BANKS]) {
+        Reg32 * current = _masked[CPU::id()];
+        for(unsigned int b = 0; b < BANKS; b++) {
+            current[b] &= ~masked[b];
+            if(masked[b] & _enabled[b])
+                irq()->enable(b, masked[b] & _enabled[b]);
+        }
+    }
+
     static Interrupt_Id int_id() {
         Interrupt_Id id = mbox()->int_id(); // check mailbox first
         if(id == LAST_INT) // if it wasn't the mailbox that triggered the interrupt, then check irq
@@ -74,11 +121,26 @@ public:
 
     static void mailbox_eoi(Interrupt_Id id) {mbox()->eoi(id); }
 
-    static void init() { mbox()->init(); }; // irq doesn't need initialization
+    static void init() {
+        mbox()->init(); // irq doesn't need initialization
+
+        for(Interrupt_Id i = 0; i < BANKS * 32; i++)
+            _priority[i] = PRIORITY_NORMAL;
+        for(unsigned int b = 0; b < BANKS; b++)
+            _level[level(PRIORITY_NORMAL)][b] = ~0;
+    };
 
 private:
+    static unsigned int level(const Priority & p) { return p >> 5; }
+
     static BCM_IRQ * irq() { return reinterpret_cast<BCM_IRQ *>(Memory_Map::IC_BASE); }
     static BCM_Mailbox * mbox() { return reinterpret_cast<BCM_Mailbox *>(Memory_Map::MBOX_CTRL_BASE); }
+
+private:
+    static Priority _priority[BANKS * 32];
+    static Reg32 _level[LEVELS][BANKS];         // interrupts at each priority level, per bank
+    static volatile Reg32 _enabled[BANKS];      // interrupts enabled through enable(i), per bank
+    static Reg32 _masked[Traits<Build>::CPUS][BANKS]; // interrupts currently disabled by mask(), per CPU and bank
 };
 
 __END_SYS
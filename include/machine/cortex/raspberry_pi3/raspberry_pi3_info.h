@@ -56,7 +56,7 @@ public:
         PAddr sys_stack;        // OS Stack segment  (used only during init and for ukernels, with one stack per core)
         PAddr app_code;         // First Application code segment
         PAddr app_data;         // First Application data segment (including heap, stack, and extra)
-        PAddr app_extra;        // APP EXTRA segment (copied from the boot image)
+        PAddr app_extra;        // APP EXTRA segment (mapped in place or copied from the boot image)
         PAddr usr_mem_base;     // User-visible memory base address
         PAddr usr_mem_top;      // User-visible memory top address
         PAddr free1_base;       // First free memory chunk base address
@@ -112,6 +112,7 @@ public:
     Boot_Map bm;
     Physical_Memory_Map pmm;
     Load_Map lm;
+    Boot_Trace bt;
 };
 
 __END_SYS
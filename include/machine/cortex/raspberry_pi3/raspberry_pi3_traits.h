@@ -69,6 +69,10 @@ template<> struct Traits<IC>: public Traits<Machine_Common>
 
     static const unsigned int IRQS = 96;
     static const unsigned int INTS = 128;
+
+    // Run interrupt handlers on a per-CPU stack instead of on the interrupted thread's kernel stack
+    static const bool irq_stack = true;
+    static const unsigned int IRQ_STACK_SIZE = 8 * 1024; // per CPU, with room for nested interrupts
 };
 
 template<> struct Traits<Timer>: public Traits<Machine_Common>
@@ -96,6 +100,8 @@ template<> struct Traits<UART>: public Traits<Machine_Common>
     static const unsigned int DEF_DATA_BITS = 8;
     static const unsigned int DEF_PARITY = 0; // none
     static const unsigned int DEF_STOP_BITS = 1;
+
+    static const unsigned int BUFFER_SIZE = 256; // per direction, for interrupt-driven read() and write()
 };
 
 template<> struct Traits<GPIO>: public Traits<Machine_Common>
@@ -29,6 +29,8 @@ public:
         INT_NIC0_ERR    = GIC::IRQ_ETHERNET0,
         INT_NIC0_TIMER  = 0,
         INT_USB0        = GIC::IRQ_USB0,
+        INT_UART0       = GIC::IRQ_UART0,
+        INT_UART1       = GIC::IRQ_UART1,
         INT_FIRST_HARD  = GIC::HARD_INT,
         INT_LAST_HARD   = GIC::IRQ_PARITY,
         INT_RESCHEDULER = GIC::IRQ_SOFTWARE0,
@@ -43,7 +45,14 @@ public:
     static void enable() { gic_distributor()->enable(); }
     static void enable(Interrupt_Id id)  { gic_distributor()->enable(id); }
     static void disable() { gic_distributor()->disable(); }
-    static void disable(Interrupt_Id id) { gic_distributor()->disable(); }
+    static void disable(Interrupt_Id id) { gic_distributor()->disable(id); }
+
+    static Priority priority(Interrupt_Id id) { return gic_distributor()->priority(id); }
+    static void priority(Interrupt_Id id, const Priority & p) { gic_distributor()->priority(id, p); }
+
+    // Priority masking of the current CPU, used by IC::dispatch() to allow only more urgent interrupts to nest
+    static Priority mask() { return gic_cpu()->mask(); }
+    static void mask(const Priority & p) { gic_cpu()->mask(p); }
 
     static Interrupt_Id int_id() { return gic_cpu()->int_id(); }
     static Interrupt_Id irq2int(Interrupt_Id id) { return gic_distributor()->irq2int(id); }
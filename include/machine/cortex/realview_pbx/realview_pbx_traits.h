@@ -95,6 +95,8 @@ template<> struct Traits<UART>: public Traits<Machine_Common>
     static const unsigned int DEF_DATA_BITS = 8;
     static const unsigned int DEF_PARITY = 0; // none
     static const unsigned int DEF_STOP_BITS = 1;
+
+    static const unsigned int BUFFER_SIZE = 256; // per direction, for interrupt-driven read() and write()
 };
 
 template<> struct Traits<Serial_Display>: public Traits<Machine_Common>
@@ -15,6 +15,18 @@ public:
         SLAVE,
     };
 
+    // Element of a transfer list: size bytes read from (read = true) or written to the slave at address. A repeated
+    // start separates consecutive elements and a stop ends the last one.
+    struct Segment {
+        unsigned char address;
+        bool read;
+        char * data;
+        unsigned int size;
+    };
+
+    // Transfer completion handler, called from the interrupt handler; ok is false if the slave did not acknowledge
+    typedef void (Callback)(bool ok, void * data);
+
 protected:
     I2C_Common() {}
 
@@ -27,6 +39,10 @@ public:
     bool read(char slave_address, char * data, unsigned int size, bool stop = true);
     bool write(unsigned char slave_address, const char * data, unsigned int size, bool stop = true);
 
+    bool transfer(const Segment * list, unsigned int n, Callback * callback = 0, void * data = 0);
+    bool wait();
+    bool done();
+
     void flush();
     bool ready_to_get();
     bool ready_to_put();
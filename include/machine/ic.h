@@ -15,6 +15,16 @@ public:
 
     static const unsigned int UNSUPPORTED_INTERRUTP = ~1;
 
+    // Interrupt priorities: lower values are more urgent and a handler can only be preempted by interrupts with strictly
+    // lower values. Controllers implement as many of the most significant bits as their hardware (or emulation) allows.
+    typedef unsigned char Priority;
+    enum {
+        PRIORITY_HIGHEST        = 0x00,
+        PRIORITY_HIGH           = 0x40,
+        PRIORITY_NORMAL         = 0x80,
+        PRIORITY_LOW            = 0xc0
+    };
+
     enum {
         INT_SYS_TIMER   = UNSUPPORTED_INTERRUTP,
         INT_USER_TIMER0 = UNSUPPORTED_INTERRUTP,
@@ -60,6 +70,9 @@ public:
     static void disable();
     static void disable(Interrupt_Id id);
 
+    static Priority priority(Interrupt_Id id);
+    static void priority(Interrupt_Id id, const Priority & p);
+
     static Interrupt_Id irq2int(Interrupt_Id id);       // Offset IRQs as seen by the bus to INTs seen by the CPU (if needed)
     static Interrupt_Id int2irq(Interrupt_Id irq);      // Offset INTs as seen by the CPU to IRQs seen by the bus (if needed)
 
@@ -123,6 +123,7 @@ public:
     Physical_Memory_Map pmm;
     Load_Map lm;
     Time_Map tm;
+    Boot_Trace bt;
 };
 
 __END_SYS
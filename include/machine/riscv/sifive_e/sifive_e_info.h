@@ -112,6 +112,7 @@ public:
     Boot_Map bm;
     Physical_Memory_Map pmm;
     Load_Map lm;
+    Boot_Trace bt;
 };
 
 __END_SYS
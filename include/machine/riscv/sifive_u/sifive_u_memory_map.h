@@ -45,9 +45,9 @@ struct Memory_Map
         SYS             = Traits<Machine>::SYS,
         SYS_CODE        = Traits<System>::multitask ? SYS + 0x00000000 : NOT_USED,
         SYS_INFO        = Traits<System>::multitask ? SYS + 0x00100000 : NOT_USED,
-        SYS_PT          = Traits<System>::multitask ? SYS + 0x00101000 : NOT_USED,
-        SYS_PD          = Traits<System>::multitask ? SYS + 0x00102000 : NOT_USED,
-        SYS_DATA        = Traits<System>::multitask ? SYS + 0x00103000 : NOT_USED,
+        SYS_PT          = Traits<System>::multitask ? SYS + 0x00101000 : NOT_USED, // 2 x 4 KB (Sv39 PTs map 2 MB each)
+        SYS_PD          = Traits<System>::multitask ? SYS + 0x00103000 : NOT_USED, // 5 x 4 KB (root + 4 level-1 tables)
+        SYS_DATA        = Traits<System>::multitask ? SYS + 0x00108000 : NOT_USED,
         SYS_STACK       = Traits<System>::multitask ? SYS + 0x00200000 : NOT_USED,
         SYS_HEAP        = Traits<System>::multitask ? SYS + 0x00400000 : NOT_USED
     };
@@ -25,6 +25,17 @@ public:
         SLAVE_OD
     };
 
+    // Element of a scatter/gather list for DMA transfers: size bytes are shifted out from tx (zeros if null) while as
+    // many are shifted in to rx (discarded if null). Buffers must be physically contiguous (e.g. MMU::DMA_Buffer).
+    struct Segment {
+        const void * tx;
+        void * rx;
+        unsigned int size;
+    };
+
+    // Transfer completion handler, called from the interrupt handler
+    typedef void (Callback)(void * data);
+
 protected:
     SPI_Common() {}
 
@@ -43,6 +54,10 @@ public:
     bool ready_to_get();
     bool ready_to_put();
 
+    bool transfer(const Segment * list, unsigned int n, Callback * callback = 0, void * data = 0);
+    void wait();
+    bool done();
+
     void int_enable(bool receive = true, bool transmit = true, bool time_out = true, bool overrun = true);
     void int_disable(bool receive = true, bool transmit = true, bool time_out = true, bool overrun = true);
 };
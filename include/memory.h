@@ -5,6 +5,7 @@
 
 #include <architecture.h>
 #include <utility/list.h>
+#include <utility/hash.h>
 
 __BEGIN_SYS
 
@@ -51,14 +52,19 @@ public:
     typedef MMU::Flags Flags;
 
 public:
-    Segment(unsigned int bytes, Flags flags = Flags::APP);
+    Segment(unsigned int bytes, Flags flags = Flags::APP, Color color = WHITE);
     Segment(Phy_Addr phy_addr, unsigned int bytes, Flags flags);
+    Segment(unsigned int bytes, Flags flags, Color color, bool populated);
     ~Segment();
 
     unsigned int size() const;
     Phy_Addr phy_address() const;
     int resize(int amount);
 
+    void share(unsigned int offset, Phy_Addr frame);
+    Phy_Addr populate(unsigned int offset, Color color = WHITE);
+    Phy_Addr frame(unsigned int offset) const;
+
 private:
     Segment(Phy_Addr pt, unsigned int from, unsigned int to, Flags flags): Chunk(pt, from, to, flags) {
         db<Segment>(TRC) << "Segment(pt=" << pt << ",from=" << from << ",to=" << to << ",flags=" << flags << ") [Chunk::pt=" << Chunk::pt() << ",sz=" << Chunk::size() << "] => " << this << endl;
@@ -80,25 +86,85 @@ public:
 */
 
 
-class Shared_Segment: public Segment
+// Set of cache colors (see MMU::phy2color()) from which the frames of a task are allocated. Palettes taken with a
+// number of colors hold them exclusively, so their tasks do not compete for the same L2 cache sets with any other task.
+// The empty palette (best effort) draws from the colors no palette holds, or is WHITE while nobody asked for colors.
+class Palette
 {
 private:
-    int _port;
-    typedef List<Shared_Segment> SS_List;
+    static const unsigned int COLORS = Traits<MMU>::colorful ? Traits<MMU>::COLORS : 0;
+    static const unsigned int ALL = ((1 << COLORS) - 1) << COLOR_1;
 
 public:
-    static SS_List _shared_segments;
+    Palette(): _colors(0), _last(0) {}
+
+    // Takes n colors for exclusive use; yields the empty palette if there are not that many left
+    static Palette take(unsigned int n);
+    void release();
+
+    // Cycles through the colors of the palette, one per call (i.e. per page or per segment)
+    Color color();
+
+    bool colored() const { return _colors || _taken; }
+    unsigned int colors() const { return _colors; }
+
+private:
+    static void lock() { CPU::int_disable(); }
+    static void unlock() { CPU::int_enable(); }
+
+private:
+    unsigned int _colors; // bitmap, bit c for COLOR_c
+    unsigned int _last;
+
+    static unsigned int _taken;
+};
+
+
+class Shared_Segment: public Segment
+{
+private:
+    static const unsigned int PORTS = 16;
+
+    typedef CPU::Log_Addr Log_Addr;
+    typedef Simple_Hash<Shared_Segment, PORTS, unsigned int> Registry;
+    typedef Registry::Element Element;
+    typedef Simple_List<Address_Space> Holders;
 
 public:
-    Shared_Segment(int port, unsigned int bytes);
+    // Find the segment bound to port (or create it with the given size) and take a reference to it on behalf of as
+    static Shared_Segment * get(Address_Space * as, int port, unsigned int bytes);
+    // Drop the reference as took with get(), deleting the segment (and freeing the port) with the last one
+    static bool put(Address_Space * as, Shared_Segment * seg);
+
+    // Take a reference and map the segment into as / detach it from as and drop that reference
+    static Log_Addr attach(Address_Space * as, int port, unsigned int bytes);
+    static bool detach(Address_Space * as, int port);
 
     static Shared_Segment * using_port(int port);
 
-    void set_port(int port) {_port = port;}
-    int get_port() {return _port;}
-};
+    int get_port() { return _port; }
+    unsigned int references() const { return _references; }
 
+private:
+    Shared_Segment(int port, unsigned int bytes);
+    ~Shared_Segment();
+
+    static Shared_Segment * acquire(Address_Space * as, int port, unsigned int bytes, bool attaching);
+    static Shared_Segment * release(Address_Space * as, Shared_Segment * seg, bool attached);
+    void unreference();
 
+    static void lock() { CPU::int_disable(); }
+    static void unlock() { CPU::int_enable(); }
+
+private:
+    int _port;
+    unsigned int _references;
+    Element _link;
+    Holders _holders;       // address spaces holding references taken with get()
+    Holders _attachments;   // address spaces the segment was attached to with attach()
+
+    static Registry _registry;
+};
 
 __END_SYS
 
@@ -7,6 +7,7 @@
 #include <machine.h>
 #include <utility/queue.h>
 #include <utility/handler.h>
+#include <utility/hash.h>
 #include <memory.h>
 #include <scheduler.h>
 
@@ -118,6 +119,12 @@ protected:
     static void reschedule();
     static void time_slicer(IC::Interrupt_Id interrupt);
 
+    // Handlers running on a dedicated interrupt stack cannot switch threads, so IC::dispatch() brackets them with
+    // int_enter() and int_leave() and reschedule() is deferred until the outermost handler has returned (per CPU, like
+    // the interrupt nesting the IC keeps)
+    static void int_enter() { _in_interrupt[CPU::id()] = true; }
+    static void int_leave();
+
     static void dispatch(Thread * prev, Thread * next, bool charge = true);
 
     static int idle();
@@ -136,6 +143,8 @@ protected:
     Queue::Element _link;
 
     static volatile unsigned int _thread_count;
+    static volatile bool _in_interrupt[Traits<Build>::CPUS];
+    static volatile bool _reschedule_deferred[Traits<Build>::CPUS];
     static Scheduler_Timer * _timer;
     static Scheduler<Thread> _scheduler;
 };
@@ -159,23 +168,33 @@ protected:
         lock();
         _id = _task_count++;
         unlock();
+        _loaded = Traits<Tracer>::boot_trace ? TSC::time_stamp() : 0;
         _current = this;
         activate();
         _main = new (SYSTEM) Thread(Thread::Configuration(Thread::RUNNING, Thread::LOADER, Traits<Application>::STACK_SIZE, this), entry, an ...);
     }
 
-public:
+    // Used by load(), so the stack of the main thread already comes from the task's palette
     template<typename ... Tn>
-    Task(Segment * cs, Segment * ds, int (* entry)(Tn ...), const Log_Addr & code, const Log_Addr & data, Tn ... an)
-    : _as (new (SYSTEM) Address_Space), _cs(cs), _ds(ds), _entry(entry), _code(_as->attach(_cs, code)), _data(_as->attach(_ds, data)) {
-        db<Task>(TRC) << "Task(as=" << _as << ",cs=" << _cs << ",ds=" << _ds << ",entry=" << _entry << ",code=" << _code << ",data=" << _data << ") => " << this << endl;
+    Task(const Palette & palette, Segment * cs, Segment * ds, int (* entry)(Tn ...), const Log_Addr & code, const Log_Addr & data, Tn ... an)
+    : _as (new (SYSTEM) Address_Space), _cs(cs), _ds(ds), _entry(entry), _code(_as->attach(_cs, code)), _data(_as->attach(_ds, data)), _palette(palette) {
+        db<Task>(TRC) << "Task(as=" << _as << ",cs=" << _cs << ",ds=" << _ds << ",entry=" << _entry << ",code=" << _code << ",data=" << _data << ",colors=" << hex << _palette.colors() << ") => " << this << endl;
         lock();
         _id = _task_count++;
         unlock();
+        _loaded = Traits<Tracer>::boot_trace ? TSC::time_stamp() : 0;
         _main = new (SYSTEM) Thread(Thread::Configuration(Thread::READY, Thread::MAIN, Traits<Application>::STACK_SIZE, this), entry, an ...);
     }
+
+public:
+    template<typename ... Tn>
+    Task(Segment * cs, Segment * ds, int (* entry)(Tn ...), const Log_Addr & code, const Log_Addr & data, Tn ... an)
+    : Task(Palette(), cs, ds, entry, code, data, an ...) {}
     ~Task();
 
+    // colors > 0 gives the task that many cache colors for its exclusive use (see Palette)
+    static Task * load(const Log_Addr & image, unsigned int heap_size, unsigned int colors = 0);
+
     Address_Space * address_space() const { return _as; }
 
     Segment * code_segment() const { return _cs; }
@@ -191,9 +210,12 @@ public:
 
     unsigned int id() {return _id;}
 
+    // Color for the next segment of the task
+    Color color() { return _palette.color(); }
+
+    // Directory::activate() invalidates whatever the MMU cannot tell apart (i.e. all but ASID-tagged translations)
     void activate_context() {
         activate();
-        MMU::flush_tlb();
         lock();
         _current = this;
         unlock();
@@ -208,6 +230,10 @@ private:
     static Task * volatile current() { return _current; }
     static void current(Task * t) { _current = t; }
 
+    static void load_segment(Segment * seg, const Log_Addr & base, ELF * elf, const Log_Addr & image, int i, Palette & palette);
+
+    void boot_trace();
+
     static void lock() { CPU::int_disable(); }
     static void unlock() { CPU::int_enable(); }
 
@@ -221,6 +247,8 @@ private:
     Log_Addr _data;
     Thread * _main;
     Thread::Queue _threads;
+    TSC::Time_Stamp _loaded;
+    Palette _palette;
 
     static Task * volatile _current;
 
@@ -258,6 +286,42 @@ private:
     Thread * _handler;
 };
 
+
+// Threaded interrupt handling: the top half, run by IC::dispatch, only masks the interrupt line and wakes a dedicated
+// thread, which runs the device handler under the scheduler and then unmasks the line. The time spent in IRQ context
+// is thus bounded and short, while the device work can be preempted. The priority given at construction places the
+// handler above, among or below the application's (real-time) threads.
+class IRQ_Thread: public Thread
+{
+private:
+    static const unsigned int HANDLERS = 8; // hash size (more handlers become synonyms)
+
+    typedef IC::Interrupt_Id Interrupt_Id;
+    typedef IC::Interrupt_Handler Interrupt_Handler;
+    typedef Simple_Hash<IRQ_Thread, HANDLERS, unsigned int> Table;
+    typedef Table::Element Element;
+
+public:
+    IRQ_Thread(const Interrupt_Id & id, const Interrupt_Handler & handler, const Criterion & priority = HIGH);
+    ~IRQ_Thread();
+
+    const Interrupt_Id & interrupt() const { return _id; }
+    unsigned int serviced() const { return _serviced; }
+
+private:
+    static int body(IRQ_Thread * t);
+    static void top_half(Interrupt_Id id);
+
+private:
+    Interrupt_Id _id;
+    Interrupt_Handler _handler;
+    volatile unsigned int _pending;
+    unsigned int _serviced;
+    Element _irq_link;
+
+    static Table _table;
+};
+
 template<typename ... Tn>
 inline Thread::Thread(int (* entry)(Tn ...), Tn ... an)
 :_task(Task::self()), _state(READY), _waiting(0), _joining(0), _link(this, NORMAL)
@@ -278,7 +342,7 @@ inline Thread::Thread(const Configuration & conf, int (* entry)(Tn ...), Tn ...
     if (conf.criterion == Thread::IDLE) {
         _context = CPU::init_stack(0, _stack + conf.stack_size, &__exit, entry, an ...);
     } else {
-        _ustack = new (SYSTEM) Segment(Traits<Machine>::STACK_SIZE, Segment::Flags::APP);
+        _ustack = new (SYSTEM) Segment(Traits<Machine>::STACK_SIZE, Segment::Flags(Segment::Flags::APP), _task->color());
         CPU::Log_Addr usp = _task->address_space()->attach(_ustack);
         db<Thread>(TRC) << "UStack attached at vaddr=" << usp << endl;
         _context = CPU::init_user_stack(usp + Traits<Machine>::STACK_SIZE, _stack + Traits<Machine>::STACK_SIZE, &__exit, entry, an ...);
@@ -5,6 +5,7 @@
 
 #include <architecture.h>
 #include <utility/handler.h>
+#include <utility/hash.h>
 #include <process.h>
 
 __BEGIN_SYS
@@ -78,6 +79,39 @@ public:
 };
 
 
+// Sleeps on a memory word instead of on a kernel object, so user-level synchronization (e.g. channels over a
+// Shared_Segment) only enters the kernel when it actually needs to block. Words are identified by their physical
+// address, thus tasks mapping the same memory at different addresses still meet on the same Futex.
+class Futex: protected Synchronizer_Common
+{
+private:
+    static const unsigned int WORDS = 16;
+
+    typedef Simple_Hash<Futex, WORDS, unsigned int> Table;
+    typedef Table::Element Element;
+
+public:
+    // Sleeps only if *word still holds expected, thus a wake() issued after *word changed is never lost
+    static bool wait(volatile unsigned int * word, unsigned int expected);
+    // Wakes up to count threads sleeping on word and returns how many were woken
+    static unsigned int wake(volatile unsigned int * word, unsigned int count);
+
+private:
+    Futex(unsigned int key);
+
+    bool sleep_if(volatile unsigned int * word, unsigned int expected);
+    unsigned int wakeup(unsigned int count);
+
+    static unsigned int key(volatile unsigned int * word);
+    static Futex * get(unsigned int key, bool create);
+
+private:
+    Element _link;
+
+    static Table _table;
+};
+
+
 // An event handler that triggers a mutex (see handler.h)
 class Mutex_Handler: public Handler
 {
@@ -11,6 +11,7 @@
 #include <memory.h>
 #include <process.h>
 #include <synchronizer.h>
+#include <tracer.h>
 #include <time.h>
 #include <utility/fork.h>
 
@@ -25,6 +26,13 @@ public:
         agt->exec();
     }
     void exec() {
+        Tracer::trace<Framework>(Tracer::SYSCALL_ENTRY, entity(), method());
+        dispatch();
+        Tracer::trace<Framework>(Tracer::SYSCALL_EXIT, entity(), method());
+    }
+
+private:
+    void dispatch() {
         switch(entity()) {
             case Message::ENTITY::FORK:
                 handle_fork();
@@ -68,12 +76,23 @@ public:
             case Message::ENTITY::SHARED_SEGMENT:
                 handle_shared_segment();
                 break;
+            case Message::ENTITY::FUTEX:
+                handle_futex();
+                break;
+            case Message::ENTITY::IRQ_PROFILER:
+                handle_irq_profiler();
+                break;
+            case Message::ENTITY::BOOT_TRACER:
+                handle_boot_tracer();
+                break;
+            case Message::ENTITY::PMU:
+                handle_pmu();
+                break;
             default:
                 break;
         }
     }
 
-private:
     void handle_fork() {
         switch(method()) {
             case Message::DO_FORK: {
@@ -94,7 +113,7 @@ private:
                 char * s;
                 get_params(s);
                 const char * cs = reinterpret_cast<const char *>(s);
-                Display::puts(cs);
+                System::print(cs);
             } break;
             default:
                 db<Agent>(TRC) << "ENTITY DEFAULT" << endl;
@@ -115,13 +134,12 @@ private:
                 get_params(entry);
                 new (SYSTEM) Thread(entry);
             }   break;
-            /*
             case Message::THREAD_PRIORITY1: {
                 Thread * t = reinterpret_cast<Thread *>(id());
-                Criterion & p;
+                int p;
                 get_params(p);
-                t->priority(p);
-            } */
+                t->priority(Thread::Criterion(p));
+            }   break;
             case Message::THREAD_TASK: {
                 Thread * t = reinterpret_cast<Thread *>(id());
                 Task * task = t->task();
@@ -179,6 +197,14 @@ private:
                 result(reinterpret_cast<int>(t));
                 db<Agent>(TRC) << "AGENTE TASK CREATE" << endl;
             }   break;
+            case Message::TASK_LOAD: {
+                Address_Space::Log_Addr image;
+                unsigned int heap_size;
+                unsigned int colors;
+                get_params(image, heap_size, colors);
+                Task * t = Task::load(image, heap_size, colors);
+                result(reinterpret_cast<int>(t));
+            }   break;
             case Message::TASK_ADDRESS_SPACE: {
                 Task * t = reinterpret_cast<Task *>(id());
                 Address_Space * a = t->address_space();
@@ -280,7 +306,7 @@ private:
                 unsigned int bytes;
                 Segment::Flags flags;
                 get_params(bytes, flags);
-                Segment * s = new (SYSTEM) Segment(bytes, flags);
+                Segment * s = new (SYSTEM) Segment(bytes, flags, Task::self()->color());
                 result(reinterpret_cast<int>(s));
             }   break;
             case Message::SEGMENT_CREATE_PHY: {
@@ -315,6 +341,10 @@ private:
                 int r = s->resize(amount);
                 result(r);
             } break;
+            case Message::SEGMENT_DELETE: {
+                Segment * s = reinterpret_cast<Segment *>(id());
+                delete s;
+            } break;
             default:
                 db<Agent>(TRC) << "FAILED :(" << endl;
                 break;
@@ -519,14 +549,25 @@ private:
                 int port;
                 unsigned int bytes;
                 get_params(port, bytes);
-                Shared_Segment * shared_seg = Shared_Segment::using_port(port);
-                if (!shared_seg) {
-                    db<Agent>(TRC) << "---SSS NOT FOUND : (---" << endl;
-                    shared_seg = new (SYSTEM) Shared_Segment(port, bytes);
-                }
+                Shared_Segment * shared_seg = Shared_Segment::get(Task::self()->address_space(), port, bytes);
                 result(reinterpret_cast<int>(shared_seg));
                 db<Agent>(TRC) << "Stub Shared Segment CREATE" << endl;
             }   break;
+            case Message::SHARED_SEGMENT_DELETE: {
+                Shared_Segment * shared_seg = reinterpret_cast<Shared_Segment*>(id());
+                result(Shared_Segment::put(Task::self()->address_space(), shared_seg));
+            }   break;
+            case Message::SHARED_SEGMENT_ATTACH: {
+                int port;
+                unsigned int bytes;
+                get_params(port, bytes);
+                result(Shared_Segment::attach(Task::self()->address_space(), port, bytes));
+            }   break;
+            case Message::SHARED_SEGMENT_DETACH: {
+                int port;
+                get_params(port);
+                result(Shared_Segment::detach(Task::self()->address_space(), port));
+            }   break;
             case Message::SHARED_SEGMENT_PORT: {
                 Shared_Segment * shared_seg = reinterpret_cast<Shared_Segment*>(id());
                 int port = shared_seg->get_port();
@@ -538,6 +579,93 @@ private:
                 break;
         }
     }
+    void handle_futex(){
+        switch(method()) {
+            case Message::FUTEX_WAIT: {
+                volatile unsigned int * word;
+                unsigned int expected;
+                get_params(word, expected);
+                result(Futex::wait(word, expected));
+            }   break;
+            case Message::FUTEX_WAKE: {
+                volatile unsigned int * word;
+                unsigned int count;
+                get_params(word, count);
+                result(Futex::wake(word, count));
+            }   break;
+            default:
+                db<Agent>(TRC) << "FAILED :(" << endl;
+                break;
+        }
+    }
+
+    void handle_irq_profiler(){
+        switch(method()) {
+            case Message::IRQ_PROFILER_PROFILE: {
+                unsigned int id;
+                IRQ_Profiler::Profile * profile;
+                get_params(id, profile);
+                result(IRQ_Profiler::profile(id, profile));
+            }   break;
+            default:
+                db<Agent>(TRC) << "FAILED :(" << endl;
+                break;
+        }
+    }
+
+    void handle_boot_tracer(){
+        switch(method()) {
+            case Message::BOOT_TRACER_TRACE: {
+                Boot_Trace * trace;
+                get_params(trace);
+                result(Boot_Tracer::trace(trace));
+            }   break;
+            default:
+                db<Agent>(TRC) << "FAILED :(" << endl;
+                break;
+        }
+    }
+
+    // The mediator is fully qualified, since PMU also names the entity in Message. Machines without a PMU mediator
+    // (__PMU_H) only have PMU_Common, whose limits are not public, so every request simply fails there.
+    void handle_pmu(){
+#ifdef __PMU_H
+        switch(method()) {
+            case Message::PMU_CONFIG: {
+                _SYS::PMU::Channel channel;
+                _SYS::PMU::Event event;
+                get_params(channel, event);
+                if((channel < _SYS::PMU::CHANNELS) && (event < _SYS::PMU::EVENTS)) {
+                    _SYS::PMU::config(channel, event);
+                    result(true);
+                } else
+                    result(false);
+            }   break;
+            case Message::PMU_READ: {
+                _SYS::PMU::Channel channel;
+                get_params(channel);
+                result((channel < _SYS::PMU::CHANNELS) ? _SYS::PMU::read(channel) : 0);
+            }   break;
+            case Message::PMU_RESET: {
+                _SYS::PMU::Channel channel;
+                get_params(channel);
+                if(channel < _SYS::PMU::CHANNELS)
+                    _SYS::PMU::reset(channel);
+            }   break;
+            case Message::PMU_STOP: {
+                _SYS::PMU::Channel channel;
+                get_params(channel);
+                if(channel < _SYS::PMU::CHANNELS)
+                    _SYS::PMU::stop(channel);
+            }   break;
+            default:
+                db<Agent>(TRC) << "FAILED :(" << endl;
+                break;
+        }
+#else
+        result(0);
+#endif
+    }
 };
 
 __END_SYS
@@ -32,6 +32,7 @@ public:
         THREAD_WAIT_NEXT,
 
         TASK_CREATE,
+        TASK_LOAD,
         TASK_ADDRESS_SPACE,
         TASK_CODE_SEGMENT,
         TASK_DATA_SEGMENT,
@@ -56,6 +57,7 @@ public:
         SEGMENT_PHY_ADDRESS,
         SEGMENT_REFLAG,
         SEGMENT_RESIZE,
+        SEGMENT_DELETE,
 
         MUTEX_CREATE,
         MUTEX_LOCK,
@@ -109,6 +111,21 @@ public:
         SHARED_SEGMENT_CREATE,
         SHARED_SEGMENT_NEW,
         SHARED_SEGMENT_PORT,
+        SHARED_SEGMENT_DELETE,
+        SHARED_SEGMENT_ATTACH,
+        SHARED_SEGMENT_DETACH,
+
+        FUTEX_WAIT,
+        FUTEX_WAKE,
+
+        IRQ_PROFILER_PROFILE,
+
+        BOOT_TRACER_TRACE,
+
+        PMU_CONFIG,
+        PMU_READ,
+        PMU_RESET,
+        PMU_STOP,
     };
     enum ENTITY {
         FORK,
@@ -125,6 +142,10 @@ public:
         DELAY,
         CHRONOMETER,
         SHARED_SEGMENT,
+        FUTEX,
+        IRQ_PROFILER,
+        BOOT_TRACER,
+        PMU,
     };
 public:
     template<typename ... Tn>
@@ -0,0 +1,33 @@
+// EPOS Component Declarations
+
+#ifndef __stub_boot_tracer_h
+#define __stub_boot_tracer_h
+
+#include <architecture.h>
+#include <tracer.h>
+#include <syscall/message.h>
+
+__BEGIN_API
+
+__USING_UTIL
+
+class Stub_Boot_Tracer
+{
+private:
+    typedef _SYS::Message Message;
+
+public:
+    typedef _SYS::Boot_Trace Boot_Trace;
+
+public:
+    // Copies the boot trace kept in System_Info into *trace; fails if the kernel was built without Traits<Tracer>::boot_trace
+    static bool trace(Boot_Trace * trace) {
+        Message * msg = new Message(0, Message::ENTITY::BOOT_TRACER, Message::BOOT_TRACER_TRACE, trace);
+        msg->act();
+        return msg->result();
+    }
+};
+
+__END_API
+
+#endif
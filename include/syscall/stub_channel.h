@@ -0,0 +1,220 @@
+// EPOS Component Declarations
+
+#ifndef __stub_channel_h
+#define __stub_channel_h
+
+#include <architecture.h>
+#include <utility/string.h>
+#include <syscall/stub_shared_segment.h>
+#include <syscall/stub_futex.h>
+
+__BEGIN_API
+
+__USING_UTIL
+
+// Bounded message rings laid out over a Shared_Segment that every peer maps by port. Head and tail are advanced with
+// atomic operations in user space, thus the kernel is only entered (through Stub_Futex) when a side must block because
+// the ring is empty or full, or when there is a blocked side to wake up. Messages are written and read in place:
+// reserve() and acquire() return a pointer straight into the shared slot, which is handed back with commit() and
+// release(); send() and receive() are copying shortcuts.
+// All peers must agree on port, slots and slot size. The segment is zero-filled at creation, which is a valid empty ring.
+class Stub_Channel_Common
+{
+protected:
+    typedef _SYS::CPU CPU;
+
+    struct Control {
+        volatile unsigned int head;         // next position to acquire (MPMC only)
+        volatile unsigned int tail;         // next position to reserve (MPMC only)
+        volatile unsigned int produced;     // committed messages, consumers block on it
+        volatile unsigned int consumed;     // released messages, producers block on it
+        volatile unsigned int waiting;      // threads blocked (or about to block) on produced or consumed
+    };
+
+    struct Slot {
+        volatile unsigned int sequence;     // MPMC only, relative to the ring lap (see base())
+        unsigned int position;
+        unsigned int size;
+    };
+
+protected:
+    Stub_Channel_Common(int port, unsigned int slots, unsigned int slot_size)
+    : _port(port), _slots(round(slots)), _slot_size((slot_size + sizeof(int) - 1) & ~(sizeof(int) - 1)) {
+        _control = Stub_Shared_Segment::attach(port, sizeof(Control) + _slots * (sizeof(Slot) + _slot_size));
+    }
+    ~Stub_Channel_Common() { Stub_Shared_Segment::detach(_port); }
+
+public:
+    bool valid() const { return _control; }
+
+    unsigned int slots() const { return _slots; }
+    unsigned int slot_size() const { return _slot_size; }
+    unsigned int size() const { return _control->produced - _control->consumed; }
+
+protected:
+    Slot * slot(unsigned int position) const {
+        return reinterpret_cast<Slot *>(reinterpret_cast<char *>(_control + 1) + (position & (_slots - 1)) * (sizeof(Slot) + _slot_size));
+    }
+    static Slot * slot(void * payload) { return static_cast<Slot *>(payload) - 1; }
+    static void * payload(Slot * s) { return s + 1; }
+
+    // First position of the lap position belongs to
+    unsigned int base(unsigned int position) const { return position & ~(_slots - 1); }
+
+    // Sleeps until counter moves away from observed; announcing the waiter before the kernel re-checks the counter
+    // guarantees that a concurrent signal() either sees the waiter or changes the counter before the check
+    void block(volatile unsigned int & counter, unsigned int observed) {
+        CPU::finc(_control->waiting);
+        Stub_Futex::wait(&counter, observed);
+        CPU::fdec(_control->waiting);
+    }
+
+    void signal(volatile unsigned int & counter) {
+        CPU::finc(counter);
+        if(_control->waiting)
+            Stub_Futex::wake(&counter);
+    }
+
+private:
+    // Powers of two, with at least two slots: with a single one, base(position) == position, so the MPMC sequence
+    // tags could not tell a committed slot from a free one
+    static unsigned int round(unsigned int n) {
+        unsigned int p = 2;
+        while(p < n)
+            p <<= 1;
+        return p;
+    }
+
+protected:
+    Control * _control;
+    int _port;
+    unsigned int _slots;
+    unsigned int _slot_size;
+};
+
+
+// Single producer, single consumer: produced and consumed double as tail and head, no read-modify-write on the slots
+class Stub_SPSC_Channel: public Stub_Channel_Common
+{
+public:
+    Stub_SPSC_Channel(int port, unsigned int slots, unsigned int slot_size): Stub_Channel_Common(port, slots, slot_size) {}
+
+    void * reserve() {
+        unsigned int consumed;
+        while(_control->produced - (consumed = _control->consumed) == _slots)
+            block(_control->consumed, consumed);
+        return payload(slot(_control->produced));
+    }
+
+    void commit(void * data, unsigned int size) {
+        slot(data)->size = size;
+        signal(_control->produced);
+    }
+
+    void * acquire(unsigned int * size) {
+        unsigned int produced;
+        while((produced = _control->produced) == _control->consumed)
+            block(_control->produced, produced);
+        Slot * s = slot(_control->consumed);
+        *size = s->size;
+        return payload(s);
+    }
+
+    void release(void * data) { signal(_control->consumed); }
+
+    bool send(const void * data, unsigned int size) {
+        if(size > _slot_size)
+            return false;
+        void * p = reserve();
+        memcpy(p, data, size);
+        commit(p, size);
+        return true;
+    }
+
+    unsigned int receive(void * data, unsigned int size) {
+        unsigned int n;
+        void * p = acquire(&n);
+        if(n > size)
+            n = size;
+        memcpy(data, p, n);
+        release(p);
+        return n;
+    }
+};
+
+
+// Multiple producers and consumers: positions are claimed with compare-and-swap and each slot carries a sequence number
+// telling whether it holds a message of the current lap (bounded MPMC queue by D. Vyukov)
+class Stub_MPMC_Channel: public Stub_Channel_Common
+{
+public:
+    Stub_MPMC_Channel(int port, unsigned int slots, unsigned int slot_size): Stub_Channel_Common(port, slots, slot_size) {}
+
+    void * reserve() {
+        for(;;) {
+            unsigned int consumed = _control->consumed;
+            unsigned int position = _control->tail;
+            Slot * s = slot(position);
+            int diff = s->sequence - base(position);
+            if(diff == 0) {
+                if(CPU::cas(_control->tail, position, position + 1) == position) {
+                    s->position = position;
+                    return payload(s);
+                }
+            } else if(diff < 0) // full
+                block(_control->consumed, consumed);
+        }
+    }
+
+    void commit(void * data, unsigned int size) {
+        Slot * s = slot(data);
+        s->size = size;
+        s->sequence = base(s->position) + 1;
+        signal(_control->produced);
+    }
+
+    void * acquire(unsigned int * size) {
+        for(;;) {
+            unsigned int produced = _control->produced;
+            unsigned int position = _control->head;
+            Slot * s = slot(position);
+            int diff = s->sequence - (base(position) + 1);
+            if(diff == 0) {
+                if(CPU::cas(_control->head, position, position + 1) == position) {
+                    *size = s->size;
+                    return payload(s);
+                }
+            } else if(diff < 0) // empty (or the producer has not committed yet)
+                block(_control->produced, produced);
+        }
+    }
+
+    void release(void * data) {
+        Slot * s = slot(data);
+        s->sequence = base(s->position) + _slots;
+        signal(_control->consumed);
+    }
+
+    bool send(const void * data, unsigned int size) {
+        if(size > _slot_size)
+            return false;
+        void * p = reserve();
+        memcpy(p, data, size);
+        commit(p, size);
+        return true;
+    }
+
+    unsigned int receive(void * data, unsigned int size) {
+        unsigned int n;
+        void * p = acquire(&n);
+        if(n > size)
+            n = size;
+        memcpy(data, p, n);
+        release(p);
+        return n;
+    }
+};
+
+__END_API
+
+#endif
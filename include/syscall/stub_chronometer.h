@@ -15,6 +15,8 @@ class Stub_Chronometer
 private:
     int id;
     typedef _SYS::Message Message;
+    typedef _SYS::Hertz Hertz;
+    typedef _SYS::Microsecond Microsecond;
     // typedef Message::ENTITY::SEMAPHORE SEMAPHORE;
 
 public:
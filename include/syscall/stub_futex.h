@@ -0,0 +1,35 @@
+// EPOS Component Declarations
+
+#ifndef __stub_futex_h
+#define __stub_futex_h
+
+#include <architecture.h>
+#include <syscall/message.h>
+
+__BEGIN_API
+
+__USING_UTIL
+
+class Stub_Futex
+{
+private:
+    typedef _SYS::Message Message;
+
+public:
+    // Blocks only if *word still holds expected when the kernel looks at it
+    static bool wait(volatile unsigned int * word, unsigned int expected) {
+        Message * msg = new Message(0, Message::ENTITY::FUTEX, Message::FUTEX_WAIT, word, expected);
+        msg->act();
+        return msg->result();
+    }
+
+    static unsigned int wake(volatile unsigned int * word, unsigned int count = -1U) {
+        Message * msg = new Message(0, Message::ENTITY::FUTEX, Message::FUTEX_WAKE, word, count);
+        msg->act();
+        return msg->result();
+    }
+};
+
+__END_API
+
+#endif
@@ -0,0 +1,36 @@
+// EPOS Component Declarations
+
+#ifndef __stub_irq_profiler_h
+#define __stub_irq_profiler_h
+
+#include <architecture.h>
+#include <tracer.h>
+#include <syscall/message.h>
+
+__BEGIN_API
+
+__USING_UTIL
+
+class Stub_IRQ_Profiler
+{
+private:
+    typedef _SYS::Message Message;
+
+public:
+    typedef _SYS::IRQ_Profiler::Profile Profile;
+
+    static const unsigned int INTS = _SYS::IRQ_Profiler::INTS;
+    static const unsigned int BUCKETS = _SYS::IRQ_Profiler::BUCKETS;
+
+public:
+    // Copies the histograms of interrupt id into *profile; fails if the kernel was built without Traits<Tracer>::irq_profile
+    static bool profile(unsigned int id, Profile * profile) {
+        Message * msg = new Message(0, Message::ENTITY::IRQ_PROFILER, Message::IRQ_PROFILER_PROFILE, id, profile);
+        msg->act();
+        return msg->result();
+    }
+};
+
+__END_API
+
+#endif
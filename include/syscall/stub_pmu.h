@@ -0,0 +1,53 @@
+// EPOS Component Declarations
+
+#ifndef __stub_pmu_h
+#define __stub_pmu_h
+
+#include <architecture.h>
+#include <syscall/message.h>
+
+__BEGIN_API
+
+__USING_UTIL
+
+class Stub_PMU
+{
+private:
+    typedef _SYS::Message Message;
+
+public:
+    typedef _SYS::PMU::Channel Channel;
+    typedef _SYS::PMU::Event Event;
+    typedef _SYS::PMU::Count Count;
+
+    static const unsigned int CHANNELS = _SYS::PMU::CHANNELS;
+
+public:
+    // Programs channel to count event (one of the PMU_Event tokens in Traits_Tokens) and starts it
+    static bool config(Channel channel, Event event) {
+        Message * msg = new Message(0, Message::ENTITY::PMU, Message::PMU_CONFIG, channel, event);
+        msg->act();
+        return msg->result();
+    }
+
+    // Only the lower 32 bits of the count make it through the syscall
+    static Count read(Channel channel) {
+        Message * msg = new Message(0, Message::ENTITY::PMU, Message::PMU_READ, channel);
+        msg->act();
+        return static_cast<unsigned int>(msg->result());
+    }
+
+    static void reset(Channel channel) {
+        Message * msg = new Message(0, Message::ENTITY::PMU, Message::PMU_RESET, channel);
+        msg->act();
+    }
+
+    static void stop(Channel channel) {
+        Message * msg = new Message(0, Message::ENTITY::PMU, Message::PMU_STOP, channel);
+        msg->act();
+    }
+};
+
+__END_API
+
+#endif
@@ -62,6 +62,12 @@ public:
         int r = msg->result();
         return r;
     }
+
+    // Destroys the segment, which must no longer be attached; the stub itself is still to be deleted by the caller
+    void destroy() {
+        Message * msg = new Message(id, Message::ENTITY::SEGMENT, Message::SEGMENT_DELETE);
+        msg->act();
+    }
 };
 
 __END_API
@@ -20,6 +20,7 @@ private:
     typedef _SYS::Message Message;
     typedef _SYS::MMU MMU;
     typedef _SYS::Segment Segment;
+    typedef _SYS::CPU CPU;
 
 
 public:
@@ -38,6 +39,25 @@ public:
         msg->act();
         return msg->result();
     }
+
+    // Drops this reference; the segment is destroyed (and its port freed) with the last one
+    void release() {
+        Message * msg = new Message(_id, Message::ENTITY::SHARED_SEGMENT, Message::SHARED_SEGMENT_DELETE);
+        msg->act();
+    }
+
+    // Binds to the segment on port (creating it if needed) and maps it into the caller's address space in a single call
+    static CPU::Log_Addr attach(int port, unsigned int bytes) {
+        Message * msg = new Message(0, Message::ENTITY::SHARED_SEGMENT, Message::SHARED_SEGMENT_ATTACH, port, bytes);
+        msg->act();
+        return msg->result();
+    }
+
+    static bool detach(int port) {
+        Message * msg = new Message(0, Message::ENTITY::SHARED_SEGMENT, Message::SHARED_SEGMENT_DETACH, port);
+        msg->act();
+        return msg->result();
+    }
     /*
     static void add_to_list(List::Element * e){
         _shared_ports.insert(e);
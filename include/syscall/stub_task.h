@@ -37,6 +37,19 @@ public:
         _id = msg->result();
     }
 
+    // Creates a Task straight from an ELF image in the caller's address space, mapping its pages in place when possible;
+    // colors > 0 reserves that many L2 cache colors for the new task alone (see Palette)
+    static Stub_Task * load(const void * image, unsigned int heap_size, unsigned int colors = 0) {
+        Message * msg = new Message(0, Message::ENTITY::TASK, Message::TASK_LOAD, CPU::Log_Addr(image), heap_size, colors);
+        msg->act();
+        int t = msg->result();
+        if(!t)
+            return 0;
+        Stub_Task * st = new Stub_Task();
+        st->set_id(t);
+        return st;
+    }
+
     Stub_Address_Space * address_space() {
         Message * msg = new Message(_id, Message::ENTITY::TASK, Message::TASK_ADDRESS_SPACE);
         msg->act();
@@ -38,12 +38,10 @@ public:
 
     void set_id(int _id){id = _id;};
 
-    /*
-    void priority(const Criterion & p) {
+    void priority(int p) {
         Message * msg = new Message(id, Message::ENTITY::THREAD, Message::THREAD_PRIORITY1, p);
         msg->act();
     }
-    */
 
     Stub_Task * task() {
         Message * msg = new Message(id, Message::ENTITY::THREAD, Message::THREAD_TASK);
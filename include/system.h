@@ -5,6 +5,7 @@
 
 #include <utility/string.h>
 #include <utility/heap.h>
+#include <utility/log.h>
 #include <system/info.h>
 #include <memory.h>
 
@@ -43,11 +44,22 @@ class System
 public:
     static System_Info * const info() { assert(_si); return _si; }
 
+    // Kernel console output (kout, kerr, db<> and the PRINT syscall). With Traits<Debug>::buffered, text is queued
+    // in a lock-free ring once threads are running and printed later by flush(), which is called from Thread::idle
+    // and synchronously by Machine::panic. Records dropped because the ring was full are reported by flush().
+    static void print(const char * s);
+    static void flush();
+
 private:
     static void init();
 
+private:
+    typedef Log_Ring<Traits<Debug>::buffered ? Traits<Debug>::LOG_SIZE : 2 * sizeof(int)> Log; // room for a header
+
 private:
     static System_Info * _si;
+    static Log _log;
+    static unsigned int _log_reported;
     static char _preheap[(Traits<System>::multiheap ? sizeof(Segment) : 0) + sizeof(Heap)];
     static Segment * _heap_segment;
     static Heap * _heap;
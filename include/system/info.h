@@ -8,6 +8,75 @@
 
 __BEGIN_SYS
 
+// Boot trace (kept in System_Info when Traits<Tracer>::boot_trace is set)
+// SETUP and INIT stamp the beginning of each phase with the TSC (low 32 bits); a phase lasts until the next stamped one.
+// The kernel then stamps the creation and the first dispatch of the main thread of the first TASKS tasks (by id).
+struct Boot_Trace
+{
+    static const unsigned int TASKS = 8;
+
+    struct Task_Stamps {
+        unsigned int created;
+        unsigned int started;
+    };
+
+    enum Phase {
+        SETUP,              // SETUP entry
+        BUILD_LM,
+        BUILD_PMM,
+        PAGE_TABLES,        // setup_*_pt(), setup_sys_pd()
+        PAGING,             // enable_paging()
+        LOAD_PARTS,
+        INIT,               // Init_Begin
+        CPU_INIT,
+        HEAP_INIT,
+        MACHINE_INIT,
+        TIMER_INIT,
+        DEVICES_INIT,       // USB, SPI, NICs, ...
+        SYSTEM_INIT,
+        ALARM_INIT,
+        THREAD_INIT,
+        INIT_END,
+        PHASES
+    };
+
+    void reset() {
+        stamped = 0;
+        frequency = 0;
+        tasks = 0;
+    }
+
+    void stamp(Phase phase, unsigned int ts) {
+        time_stamp[phase] = ts;
+        stamped |= 1 << phase;
+    }
+
+    bool has(unsigned int phase) const { return stamped & (1 << phase); }
+
+    void stamp(unsigned int task, unsigned int created, unsigned int started) {
+        if(task >= TASKS)
+            return;
+        this->task[task].created = created;
+        this->task[task].started = started;
+        tasks |= 1 << task;
+    }
+
+    bool has_task(unsigned int task) const { return (task < TASKS) && (tasks & (1 << task)); }
+
+    static const char * name(unsigned int phase) {
+        static const char * names[PHASES] = { "SETUP", "BUILD_LM", "BUILD_PMM", "PAGE_TABLES", "PAGING", "LOAD_PARTS",
+                                              "INIT", "CPU_INIT", "HEAP_INIT", "MACHINE_INIT", "TIMER_INIT", "DEVICES_INIT",
+                                              "SYSTEM_INIT", "ALARM_INIT", "THREAD_INIT", "INIT_END" };
+        return (phase < PHASES) ? names[phase] : "?";
+    }
+
+    unsigned int stamped;               // Bitmap of the stamped phases
+    unsigned int frequency;             // TSC frequency (in Hz, set by INIT)
+    unsigned int time_stamp[PHASES];
+    unsigned int tasks;                 // Bitmap of the stamped tasks
+    Task_Stamps task[TASKS];
+};
+
 struct System_Info_Common
 {
 protected:
@@ -40,6 +109,33 @@ public:
 
 public:
     Boot_Map bm;
+    Boot_Trace bt;
+};
+
+// Each extra application or data file appended to the boot image (built by MKBI) is a page-aligned record that
+// starts with this index and is followed, at the next page boundary, by the file itself. ELF files are laid out so
+// that each PT_LOAD segment sits at an offset congruent to its address modulo the page size, with zeroed gaps,
+// so the kernel can map their pages in place. A record whose size is 0 ends the list.
+// Modifications to this index requires adjustments at MKBI and at the loaders
+struct Image_Index
+{
+    static const unsigned int PAGE_SIZE = 4096;
+    static const unsigned int MAX_SEGMENTS = 8;
+
+    struct Segment
+    {
+        unsigned int offset;          // Segment offset in the file (congruent to vaddr modulo PAGE_SIZE)
+        unsigned int vaddr;           // Segment logical address
+        unsigned int file_size;       // Segment size in the file
+        unsigned int memory_size;     // Segment size in memory (including .bss)
+        unsigned int flags;           // ELF segment flags (PF_X, PF_W, PF_R)
+    };
+
+    unsigned int size;                // Record size (in bytes, a multiple of PAGE_SIZE, 0 => last record)
+    unsigned int file_offset;         // File offset from the beginning of the record
+    unsigned int file_size;           // File size (after relayout)
+    unsigned int segments;            // Number of PT_LOAD segments described below (0 => data or unknown format)
+    Segment segment[MAX_SEGMENTS];
 };
 
 __END_SYS
@@ -34,6 +34,7 @@ class Boot;
 class Setup;
 class Init;
 class Utility;
+class Tracer;
 
 // Architecture Hardware Mediators
 class CPU;
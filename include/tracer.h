@@ -0,0 +1,226 @@
+// EPOS Binary Event Tracer Declarations
+
+#ifndef __tracer_h
+#define __tracer_h
+
+#include <architecture.h>
+#include <utility/spin.h>
+#include <system/info.h>
+
+__BEGIN_SYS
+
+// Flight recorder of fixed-size, time-stamped kernel events. Recording costs a fetch-and-increment and a few stores,
+// so it barely perturbs the timing of the traced paths, as opposed to db<>. Each call site is enabled at compile time
+// by Traits<Tracer>::enabled and the "traced" flag of the corresponding component's Traits (e.g. Traits<Thread>). The
+// ring overwrites the oldest records and is dumped to the console by dump(), in a textual form that
+// tools/epostrace converts to a Chrome/Perfetto JSON timeline.
+class Tracer
+{
+public:
+    static const unsigned int RECORDS = Traits<Tracer>::RECORDS;
+
+    typedef TSC::Time_Stamp Time_Stamp;
+
+    enum Event {
+        THREAD_DISPATCH,        // a = prev, b = next
+        IRQ_ENTRY,              // a = interrupt id
+        IRQ_EXIT,               // a = interrupt id
+        SYSCALL_ENTRY,          // a = entity, b = method
+        SYSCALL_EXIT,           // a = entity, b = method
+        ALARM_HANDLER,          // a = alarm, b = elapsed ticks
+        MUTEX_CONTENTION        // a = mutex
+    };
+
+    struct Record {
+        unsigned long long time;
+        unsigned short event;
+        unsigned short cpu;
+        unsigned int thread;
+        unsigned int a;
+        unsigned int b;
+    };
+
+public:
+    Tracer() {}
+
+    template<typename Component>
+    static void trace(const Event & event, unsigned long a = 0, unsigned long b = 0) {
+        if(Traits<Tracer>::enabled && Traits<Component>::traced)
+            record(event, a, b);
+    }
+
+    static void dump();
+
+private:
+    static void record(const Event & event, unsigned long a, unsigned long b) {
+        unsigned long long time = TSC::time_stamp(); // stamped before the slot is claimed, so it dates the event itself
+        Record * r = &_records[CPU::finc(_next) % RECORDS];
+        r->time = time;
+        r->event = event;
+        r->cpu = CPU::id();
+        r->thread = This_Thread::id();
+        r->a = a;
+        r->b = b;
+    }
+
+private:
+    static volatile unsigned int _next;
+    static Record _records[Traits<Tracer>::enabled ? RECORDS : 1];
+};
+
+
+// Per-interrupt log2 histograms of the dispatch latency (from the exception entry to the handler call) and of the
+// handler run time, both in PMU cycles. Fed by IC::dispatch on the models that stamp the exception entry (currently
+// the Raspberry Pi 3) when Traits<Tracer>::irq_profile is set. Handler times include nested interrupts and, for
+// handlers that reschedule, the time until the interrupted thread is dispatched again.
+class IRQ_Profiler
+{
+public:
+    static const unsigned int INTS = 128;       // interrupts with larger ids are not accounted
+    static const unsigned int BUCKETS = 24;     // bucket i counts samples in [2^i, 2^(i+1)) cycles, the last one saturates
+
+    typedef unsigned int Cycles;
+
+    struct Profile {
+        unsigned int count;
+        Cycles max_latency;
+        Cycles max_handler;
+        unsigned int latency[BUCKETS];
+        unsigned int handler[BUCKETS];
+    };
+
+public:
+    IRQ_Profiler() {}
+
+    // Must be called with interrupts disabled
+    static void account(unsigned int id, Cycles entry, Cycles start, Cycles end) {
+        if(!Traits<Tracer>::irq_profile || (id >= INTS))
+            return;
+
+        Profile * p = &_profiles[id];
+        Cycles latency = start - entry;
+        Cycles handler = end - start;
+        p->count++;
+        p->latency[bucket(latency)]++;
+        p->handler[bucket(handler)]++;
+        if(latency > p->max_latency)
+            p->max_latency = latency;
+        if(handler > p->max_handler)
+            p->max_handler = handler;
+    }
+
+    static bool profile(unsigned int id, Profile * p);
+    static void report();
+
+private:
+    static unsigned int bucket(Cycles c) {
+        unsigned int b = c ? 31 - __builtin_clz(c) : 0;
+        return (b < BUCKETS) ? b : BUCKETS - 1;
+    }
+
+private:
+    static Profile _profiles[Traits<Tracer>::irq_profile ? INTS : 1];
+};
+
+
+// Keeps, for each CPU, the SITES call sites that held interrupts disabled for the longest intervals (in PMU cycles on
+// Cortex-A, in TSC ticks elsewhere) when Traits<Tracer>::int_off_profile is set. Fed by CPU::int_disable() and
+// CPU::int_enable(); intervals closed by the restoring of a saved status register (e.g. on exception return) are
+// discarded on the next exception entry or context load rather than misaccounted.
+class Int_Off_Profiler
+{
+    friend class CPU;
+
+public:
+    static const unsigned int SITES = 16;
+
+    typedef unsigned int Cycles;
+
+    struct Site {
+        void * address;                         // return address of the call to CPU::int_disable()
+        Cycles max;
+        unsigned int count;
+    };
+
+public:
+    Int_Off_Profiler() {}
+
+    static void report();
+
+private:
+    // Both called with interrupts disabled
+    static void begin(void * site) {
+        unsigned int cpu = CPU::id();
+        _start[cpu] = now();
+        _site[cpu] = site;
+    }
+
+    static void end() {
+        unsigned int cpu = CPU::id();
+        if(!_site[cpu])
+            return;
+
+        Cycles elapsed = now() - _start[cpu];
+        void * site = _site[cpu];
+        _site[cpu] = 0;
+
+        Site * worst = _worst[cpu];
+        Site * least = &worst[0];
+        for(unsigned int i = 0; i < SITES; i++) {
+            if(worst[i].address == site) {
+                worst[i].count++;
+                if(elapsed > worst[i].max)
+                    worst[i].max = elapsed;
+                return;
+            }
+            if(worst[i].max < least->max)
+                least = &worst[i];
+        }
+        if(elapsed > least->max) {
+            least->address = site;
+            least->max = elapsed;
+            least->count = 1;
+        }
+    }
+
+    // The interval was ended by restoring a saved status register rather than by CPU::int_enable()
+    static void discard() { _site[CPU::id()] = 0; }
+
+    static Cycles now() {
+#ifdef __cortex_a__
+        return PMU::cycles();
+#else
+        return TSC::time_stamp();
+#endif
+    }
+
+private:
+    static const unsigned int CPUS = Traits<Tracer>::int_off_profile ? Traits<Build>::CPUS : 1;
+
+    static Cycles _start[CPUS];
+    static void * _site[CPUS];
+    static Site _worst[CPUS][SITES];
+};
+
+
+// Boot-time profile kept in System_Info (see Boot_Trace at system/info.h) when Traits<Tracer>::boot_trace is set.
+// SETUP stamps its own phases (on the models that support it) and INIT stamps the rest through stamp(), on the
+// bootstrap CPU only. Init_End prints it with report() and applications can fetch a copy with trace().
+// Thread::dispatch() stamps tasks with stamp(task, created) as their main threads first run, which is too late for
+// Init_End and too early to print anything without disturbing what is measured, so report_tasks() prints them when
+// the last thread exits.
+class Boot_Tracer
+{
+public:
+    Boot_Tracer() {}
+
+    static void stamp(Boot_Trace::Phase phase);
+    static void stamp(unsigned int task, unsigned int created);
+    static bool trace(Boot_Trace * t);
+    static void report();
+    static void report_tasks();
+};
+
+__END_SYS
+
+#endif
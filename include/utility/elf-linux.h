@@ -15,6 +15,10 @@
 #define PT_NULL 0
 #define PT_LOAD 1
 
+#define PF_X 0x1
+#define PF_W 0x2
+#define PF_R 0x4
+
 typedef unsigned short Elf32_Half;
 typedef unsigned short Elf64_Half;
 typedef unsigned long Elf32_Word;
@@ -31,10 +31,22 @@ public:
     }
 
     int segment_size(int i) {
-        return (i > segments()) ? -1 : (int)(((seg(i)->p_offset % seg(i)->p_align) + seg(i)->p_memsz + seg(i)->p_align - 1) & ~(seg(i)->p_align - 1));
+        // p_vaddr and p_offset are congruent modulo p_align, but only the former survives MKBI compressing the image
+        return (i > segments()) ? -1 : (int)(((seg(i)->p_vaddr % seg(i)->p_align) + seg(i)->p_memsz + seg(i)->p_align - 1) & ~(seg(i)->p_align - 1));
     }
 
-    int load_segment(int i, Elf32_Addr addr = 0);
+    Elf32_Word segment_flags(int i) {
+        return (i > segments()) ? 0 : seg(i)->p_flags;
+    }
+
+    // Raw program header fields, for loaders that map the image in place instead of calling load_segment()
+    Elf32_Off segment_offset(int i) { return (i > segments()) ? 0 : seg(i)->p_offset; }
+    Elf32_Addr segment_vaddr(int i) { return (i > segments()) ? 0 : seg(i)->p_vaddr; }
+    Elf32_Word segment_file_size(int i) { return (i > segments()) ? 0 : seg(i)->p_filesz; }
+    Elf32_Word segment_memory_size(int i) { return (i > segments()) ? 0 : seg(i)->p_memsz; }
+
+    // Segments whose frames were cleared beforehand (e.g. by SETUP) can skip zeroing their BSS
+    int load_segment(int i, Elf32_Addr addr = 0, bool clear = true);
 
 private:
     Elf32_Phdr * pht() { return (Elf32_Phdr *)(((char *) this) + e_phoff); }
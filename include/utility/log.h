@@ -0,0 +1,130 @@
+// EPOS Lock-free Log Ring Utility Declarations
+
+#ifndef __log_h
+#define __log_h
+
+#include <architecture.h>
+#include <utility/string.h>
+
+__BEGIN_UTIL
+
+// Multiple-producer, single-consumer ring of text records used to defer console output.
+// Producers reserve space by advancing _tail with a CAS, copy their text and only then publish the record by sealing
+// its header with the record's own position, so put() never blocks, never disables interrupts and costs little more
+// than a memcpy. Records that do not fit are dropped and accounted in dropped(). The consumer (drain()) must be unique;
+// it stops at the first record not sealed for the position it expects, so the ring is always printed in reservation
+// order and neither a producer still copying nor stale bytes of earlier records are taken for a header. Consumed
+// records are zeroed, so free space never holds a valid seal.
+template<unsigned int SIZE>
+class Log_Ring
+{
+private:
+    struct Header {
+        unsigned int seal;      // ~position of the record once published, 0 before
+        unsigned int length;
+    };
+
+    static const unsigned int CHUNK = 64;
+
+public:
+    typedef void (Printer)(const char * s);
+
+public:
+    Log_Ring(): _head(0), _tail(0), _dropped(0) {
+        assert(!(SIZE & (SIZE - 1)) && !(SIZE % sizeof(Header)));
+        clear(0, SIZE);
+    }
+
+    bool put(const char * s) {
+        unsigned int length = strlen(s);
+        if(!length)
+            return true;
+
+        unsigned int bytes = sizeof(Header) + align(length);
+        unsigned int tail;
+        do {
+            tail = _tail;
+            if(tail + bytes - _head > SIZE) {
+                CPU::finc(_dropped);
+                return false;
+            }
+        } while(CPU::cas(_tail, tail, tail + bytes) != tail);
+
+        header(tail)->length = length;
+        copy_in(tail + sizeof(Header), s, length);
+        barrier();
+        header(tail)->seal = seal(tail);
+
+        return true;
+    }
+
+    // Prints all published records; returns the number of bytes consumed
+    unsigned int drain(Printer * print) {
+        char buffer[CHUNK + 1];
+        unsigned int consumed = 0;
+
+        while(_head != _tail) {
+            if(header(_head)->seal != seal(_head))
+                break;  // still being copied by its producer
+            barrier();
+
+            unsigned int length = header(_head)->length;
+            for(unsigned int i = 0; i < length; i += CHUNK) {
+                unsigned int n = (length - i > CHUNK) ? CHUNK : length - i;
+                copy_out(buffer, _head + sizeof(Header) + i, n);
+                buffer[n] = '\0';
+                print(buffer);
+            }
+
+            clear(_head, sizeof(Header) + align(length));
+            barrier();
+            _head += sizeof(Header) + align(length);
+            consumed += length;
+        }
+
+        return consumed;
+    }
+
+    bool empty() const { return _head == _tail; }
+    unsigned int dropped() const { return _dropped; }
+
+private:
+    static unsigned int align(unsigned int n) { return (n + sizeof(Header) - 1) & ~(sizeof(Header) - 1); }
+    static unsigned int seal(unsigned int position) { return ~position; } // never 0, since positions are aligned
+
+    // Orders the accesses to the payload and to the seal, also for producers and the consumer on other cores
+    static void barrier() { __sync_synchronize(); }
+
+    volatile Header * header(unsigned int position) { return reinterpret_cast<volatile Header *>(&_data[position % SIZE]); }
+
+    void copy_in(unsigned int position, const char * s, unsigned int n) {
+        unsigned int i = position % SIZE;
+        unsigned int first = (SIZE - i < n) ? SIZE - i : n;
+        memcpy(&_data[i], s, first);
+        memcpy(&_data[0], s + first, n - first);
+    }
+
+    void copy_out(char * s, unsigned int position, unsigned int n) {
+        unsigned int i = position % SIZE;
+        unsigned int first = (SIZE - i < n) ? SIZE - i : n;
+        memcpy(s, &_data[i], first);
+        memcpy(s + first, &_data[0], n - first);
+    }
+
+    void clear(unsigned int position, unsigned int n) {
+        unsigned int i = position % SIZE;
+        unsigned int first = (SIZE - i < n) ? SIZE - i : n;
+        memset(&_data[i], 0, first);
+        memset(&_data[0], 0, n - first);
+    }
+
+private:
+    volatile unsigned int _head;
+    volatile unsigned int _tail;
+    volatile unsigned int _dropped;
+    char _data[SIZE] __attribute__((aligned(sizeof(Header))));
+};
+
+__END_UTIL
+
+#endif
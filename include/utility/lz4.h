@@ -0,0 +1,33 @@
+// EPOS LZ4 Utility Declarations
+
+#ifndef __lz4_h
+#define __lz4_h
+
+#include <system/config.h>
+
+__BEGIN_UTIL
+
+// Decoder for the LZ4 block format, used by SETUP to inflate boot image segments compressed by MKBI straight into
+// their final addresses
+class LZ4
+{
+public:
+    // ELF segment flag (within PF_MASKOS) set by MKBI on PT_LOAD segments whose file image is an LZ4 block
+    static const unsigned int PF_LZ4 = 0x00100000;
+
+    static const unsigned int MIN_MATCH = 4;
+    static const unsigned int MAX_OFFSET = 65535;
+    static const unsigned int LAST_LITERALS = 5;        // the last 5 bytes of a block are always literals
+    static const unsigned int MATCH_LIMIT = 12;         // and the last match starts at least 12 bytes before its end
+
+public:
+    LZ4() {}
+
+    // Decompresses the block at src (size bytes long) into dst, writing at most capacity bytes
+    // Returns the number of bytes written or -1 if the block is corrupted
+    static int decompress(void * dst, const void * src, unsigned int size, unsigned int capacity);
+};
+
+__END_UTIL
+
+#endif
@@ -4,68 +4,221 @@
 #define __poly1305_h
 
 #include <utility/string.h>
-#include <utility/bignum.h>
-#include <utility/math.h>
 
 __BEGIN_UTIL
 
+// Poly1305 evaluated over GF(2^130 - 5) using five 26-bit limbs (radix 2^26) with delayed carry propagation.
+// Each 16-byte block costs 25 32x32->64 multiplications and a single carry chain, avoiding the generic Bignum field
+// arithmetic (and its Barrett reduction). Messages can be authenticated incrementally with init(), update() and
+// finish(), so large payloads need not be buffered; stamp() and verify() are the one-shot equivalents.
 template<typename Cipher>
 class Poly1305
 {
-    typedef _UTIL::Bignum<17> Bignum;
+public:
+    static const unsigned int BLOCK_SIZE = 16;
+    static const unsigned int MAC_SIZE = 16;
+
+private:
+    typedef unsigned int Limb;
+    typedef unsigned long long Double_Limb;
+
+    static const Limb MASK = 0x3ffffff;     // 26 bits
+    static const Limb HIBIT = 1 << 24;      // 2^128 in the most significant limb
 
 public:
-    Poly1305(const unsigned char k[16], const unsigned char r[16]) : _k(k, 16), _r(r, 16) {
-        clamp();
+    Poly1305(const unsigned char k[16], const unsigned char r[16]): _leftover(0) {
+        this->k(k);
+        this->r(r);
     }
-    Poly1305() {}
+    Poly1305(): _leftover(0) {}
 
     void stamp(unsigned char out[16], const unsigned char nonce[16], const unsigned char * message, int message_len) {
-        // cr = (c_1 * r^q + c_2 * r^(q-1) + ... + c_q * r^1) % (2^130 - 5)
-        Bignum cr(0);
-        for(; message_len > 0; message_len -= 16, message += 16) {
-            int len = Math::min(16, message_len);
-            Bignum c(message, len);
-            reinterpret_cast<unsigned char *>(c._data)[len] = 1;
-
-            cr += c;
-            cr *= _r;
-        }
+        init(nonce);
+        if(message_len > 0)
+            update(message, message_len);
+        finish(out);
+    }
 
+    bool verify(const unsigned char mac[16], const unsigned char nonce[16], const unsigned char * message, unsigned int message_len) {
+        unsigned char my_mac[16];
+        stamp(my_mac, nonce, message, message_len);
+
+        // Constant time comparison
+        unsigned char diff = 0;
+        for(int i = 0; i < 16; i++)
+            diff |= my_mac[i] ^ mac[i];
+        return diff == 0;
+    }
+
+    // Incremental interface: init(nonce), update(chunk)*, finish(mac)
+    void init(const unsigned char nonce[16]) {
+        // pad = aes(k,n)
         unsigned char ciphertext[16];
         Cipher cipher;
-        cipher.encrypt(nonce, reinterpret_cast<const unsigned char *>(_k._data), ciphertext);
+        cipher.encrypt(nonce, _k, ciphertext);
+        for(int i = 0; i < 4; i++)
+            _pad[i] = load32(&ciphertext[4 * i]);
 
-        // out = (cr + aes(k,n)) % 2^128
-        Bignum::simple_add(reinterpret_cast<Bignum::Digit *>(out), reinterpret_cast<const Bignum::Digit *>(ciphertext), cr._data, 4);
+        _h[0] = _h[1] = _h[2] = _h[3] = _h[4] = 0;
+        _leftover = 0;
     }
 
-    bool verify(const unsigned char mac[16], const unsigned char nonce[16], const unsigned char * message, unsigned int message_len) {
-        unsigned char my_mac[16];
-        stamp(my_mac, nonce, message, message_len);
-        for(int i = 0; i < 16; i++) {
-            if(my_mac[i] != mac[i])
-                return false;
+    void update(const unsigned char * message, unsigned int message_len) {
+        // Complete a block left over from a previous call
+        if(_leftover) {
+            unsigned int want = BLOCK_SIZE - _leftover;
+            if(want > message_len)
+                want = message_len;
+            memcpy(&_buffer[_leftover], message, want);
+            message_len -= want;
+            message += want;
+            _leftover += want;
+            if(_leftover < BLOCK_SIZE)
+                return;
+            blocks(_buffer, BLOCK_SIZE, HIBIT);
+            _leftover = 0;
+        }
+
+        // Process all full blocks straight from the caller's buffer
+        if(message_len >= BLOCK_SIZE) {
+            unsigned int len = message_len & ~(BLOCK_SIZE - 1);
+            blocks(message, len, HIBIT);
+            message += len;
+            message_len -= len;
+        }
+
+        // Keep the tail for the next call
+        if(message_len) {
+            memcpy(_buffer, message, message_len);
+            _leftover = message_len;
+        }
+    }
+
+    void finish(unsigned char out[16]) {
+        // Last partial block is padded with a single 1 byte (instead of the implicit 2^128)
+        if(_leftover) {
+            _buffer[_leftover] = 1;
+            for(unsigned int i = _leftover + 1; i < BLOCK_SIZE; i++)
+                _buffer[i] = 0;
+            blocks(_buffer, BLOCK_SIZE, 0);
+            _leftover = 0;
         }
-        return true;
+
+        Limb h0 = _h[0], h1 = _h[1], h2 = _h[2], h3 = _h[3], h4 = _h[4];
+        Limb c;
+
+        // Fully carry h
+        c = h1 >> 26; h1 &= MASK;
+        h2 += c; c = h2 >> 26; h2 &= MASK;
+        h3 += c; c = h3 >> 26; h3 &= MASK;
+        h4 += c; c = h4 >> 26; h4 &= MASK;
+        h0 += c * 5; c = h0 >> 26; h0 &= MASK;
+        h1 += c;
+
+        // g = h + -p = h - (2^130 - 5)
+        Limb g0 = h0 + 5; c = g0 >> 26; g0 &= MASK;
+        Limb g1 = h1 + c; c = g1 >> 26; g1 &= MASK;
+        Limb g2 = h2 + c; c = g2 >> 26; g2 &= MASK;
+        Limb g3 = h3 + c; c = g3 >> 26; g3 &= MASK;
+        Limb g4 = h4 + c - (1 << 26);
+
+        // Select h if h < p, or g otherwise (without branching)
+        Limb mask = (g4 >> 31) - 1;
+        g0 &= mask; g1 &= mask; g2 &= mask; g3 &= mask; g4 &= mask;
+        mask = ~mask;
+        h0 = (h0 & mask) | g0;
+        h1 = (h1 & mask) | g1;
+        h2 = (h2 & mask) | g2;
+        h3 = (h3 & mask) | g3;
+        h4 = (h4 & mask) | g4;
+
+        // h = h % 2^128
+        h0 = (h0      ) | (h1 << 26);
+        h1 = (h1 >>  6) | (h2 << 20);
+        h2 = (h2 >> 12) | (h3 << 14);
+        h3 = (h3 >> 18) | (h4 <<  8);
+
+        // out = (h + aes(k,n)) % 2^128
+        Double_Limb f;
+        f = Double_Limb(h0) + _pad[0]            ; h0 = f; store32(&out[0], h0);
+        f = Double_Limb(h1) + _pad[1] + (f >> 32); h1 = f; store32(&out[4], h1);
+        f = Double_Limb(h2) + _pad[2] + (f >> 32); h2 = f; store32(&out[8], h2);
+        f = Double_Limb(h3) + _pad[3] + (f >> 32); h3 = f; store32(&out[12], h3);
+
+        _h[0] = _h[1] = _h[2] = _h[3] = _h[4] = 0;
+        _pad[0] = _pad[1] = _pad[2] = _pad[3] = 0;
     }
 
-    void k(const unsigned char k1[16]) { new (&_k) Bignum(k1,16); }
-    void r(const unsigned char r1[16]) { new (&_r) Bignum(r1,16); clamp(); }
+    void k(const unsigned char k1[16]) { memcpy(_k, k1, 16); }
+    void r(const unsigned char r1[16]) {
+        // r &= 0x0ffffffc0ffffffc0ffffffc0fffffff (clamp)
+        _r[0] = (load32(&r1[ 0])     ) & 0x3ffffff;
+        _r[1] = (load32(&r1[ 3]) >> 2) & 0x3ffff03;
+        _r[2] = (load32(&r1[ 6]) >> 4) & 0x3ffc0ff;
+        _r[3] = (load32(&r1[ 9]) >> 6) & 0x3f03fff;
+        _r[4] = (load32(&r1[12]) >> 8) & 0x00fffff;
+
+        // Precomputed r * 5 for the modular reduction by 2^130 - 5
+        _s[0] = _r[1] * 5;
+        _s[1] = _r[2] * 5;
+        _s[2] = _r[3] * 5;
+        _s[3] = _r[4] * 5;
+    }
 
 private:
-    void clamp() {
-        reinterpret_cast<unsigned char *>(_r._data)[3] &= 15;
-        reinterpret_cast<unsigned char *>(_r._data)[7] &= 15;
-        reinterpret_cast<unsigned char *>(_r._data)[11] &= 15;
-        reinterpret_cast<unsigned char *>(_r._data)[15] &= 15;
-        reinterpret_cast<unsigned char *>(_r._data)[4] &= 252;
-        reinterpret_cast<unsigned char *>(_r._data)[8] &= 252;
-        reinterpret_cast<unsigned char *>(_r._data)[12] &= 252;
+    // h = (h + c) * r % (2^130 - 5), for each 16-byte block c in message
+    void blocks(const unsigned char * message, unsigned int len, Limb hibit) {
+        const Limb r0 = _r[0], r1 = _r[1], r2 = _r[2], r3 = _r[3], r4 = _r[4];
+        const Limb s1 = _s[0], s2 = _s[1], s3 = _s[2], s4 = _s[3];
+        Limb h0 = _h[0], h1 = _h[1], h2 = _h[2], h3 = _h[3], h4 = _h[4];
+
+        for(; len >= BLOCK_SIZE; len -= BLOCK_SIZE, message += BLOCK_SIZE) {
+            // h += c
+            h0 += (load32(&message[ 0])     ) & MASK;
+            h1 += (load32(&message[ 3]) >> 2) & MASK;
+            h2 += (load32(&message[ 6]) >> 4) & MASK;
+            h3 += (load32(&message[ 9]) >> 6) & MASK;
+            h4 += (load32(&message[12]) >> 8) | hibit;
+
+            // h *= r (carries are delayed until the whole product is accumulated)
+            Double_Limb d0 = mul(h0, r0) + mul(h1, s4) + mul(h2, s3) + mul(h3, s2) + mul(h4, s1);
+            Double_Limb d1 = mul(h0, r1) + mul(h1, r0) + mul(h2, s4) + mul(h3, s3) + mul(h4, s2);
+            Double_Limb d2 = mul(h0, r2) + mul(h1, r1) + mul(h2, r0) + mul(h3, s4) + mul(h4, s3);
+            Double_Limb d3 = mul(h0, r3) + mul(h1, r2) + mul(h2, r1) + mul(h3, r0) + mul(h4, s4);
+            Double_Limb d4 = mul(h0, r4) + mul(h1, r3) + mul(h2, r2) + mul(h3, r1) + mul(h4, r0);
+
+            // Partial reduction mod 2^130 - 5
+            Limb c;
+                          c = Limb(d0 >> 26); h0 = Limb(d0) & MASK;
+            d1 += c;      c = Limb(d1 >> 26); h1 = Limb(d1) & MASK;
+            d2 += c;      c = Limb(d2 >> 26); h2 = Limb(d2) & MASK;
+            d3 += c;      c = Limb(d3 >> 26); h3 = Limb(d3) & MASK;
+            d4 += c;      c = Limb(d4 >> 26); h4 = Limb(d4) & MASK;
+            h0 += c * 5;  c = h0 >> 26;       h0 &= MASK;
+            h1 += c;
+        }
+
+        _h[0] = h0; _h[1] = h1; _h[2] = h2; _h[3] = h3; _h[4] = h4;
+    }
+
+    static Double_Limb mul(Limb a, Limb b) { return Double_Limb(a) * b; }
+
+    static Limb load32(const unsigned char * p) {
+        return Limb(p[0]) | (Limb(p[1]) << 8) | (Limb(p[2]) << 16) | (Limb(p[3]) << 24);
     }
 
-    Bignum _k;
-    Bignum _r;
+    static void store32(unsigned char * p, Limb v) {
+        p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24;
+    }
+
+private:
+    unsigned char _k[16];
+    Limb _r[5];
+    Limb _s[4];
+    Limb _h[5];
+    Limb _pad[4];
+    unsigned char _buffer[BLOCK_SIZE];
+    unsigned int _leftover;
 };
 
 __END_UTIL
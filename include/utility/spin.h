@@ -13,6 +13,7 @@ class This_Thread
 public:
     static volatile CPU::Reg id();
     static void not_booting() { _not_booting = true; }
+    static bool booting() { return !_not_booting; }
 
 private:
     static bool _not_booting;
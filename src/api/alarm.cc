@@ -4,6 +4,7 @@
 #include <synchronizer.h>
 #include <time.h>
 #include <process.h>
+#include <tracer.h>
 
 __BEGIN_SYS
 
@@ -120,6 +121,7 @@ void Alarm::handler(IC::Interrupt_Id i)
 
     if(alarm) {
         db<Alarm>(TRC) << "Alarm::handler(this=" << alarm << ",e=" << _elapsed << ",h=" << reinterpret_cast<void*>(alarm->handler) << ")" << endl;
+        Tracer::trace<Alarm>(Tracer::ALARM_HANDLER, reinterpret_cast<unsigned long>(alarm), _elapsed);
         (*alarm->_handler)();
     }
 }
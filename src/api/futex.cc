@@ -0,0 +1,92 @@
+// EPOS Futex Implementation
+
+#include <synchronizer.h>
+
+__BEGIN_SYS
+
+// Class attributes
+Futex::Table Futex::_table;
+
+// Methods
+Futex::Futex(unsigned int key): _link(this, key)
+{
+    db<Synchronizer>(TRC) << "Futex(key=" << reinterpret_cast<void *>(key) << ") => " << this << endl;
+}
+
+
+bool Futex::wait(volatile unsigned int * word, unsigned int expected)
+{
+    db<Synchronizer>(TRC) << "Futex::wait(word=" << const_cast<unsigned int *>(word) << ",expected=" << expected << ")" << endl;
+
+    return get(key(word), true)->sleep_if(word, expected);
+}
+
+
+unsigned int Futex::wake(volatile unsigned int * word, unsigned int count)
+{
+    db<Synchronizer>(TRC) << "Futex::wake(word=" << const_cast<unsigned int *>(word) << ",count=" << count << ")" << endl;
+
+    // Nobody ever waited on word, so there is nothing to wake
+    Futex * f = get(key(word), false);
+    return f ? f->wakeup(count) : 0;
+}
+
+
+bool Futex::sleep_if(volatile unsigned int * word, unsigned int expected)
+{
+    begin_atomic();
+    bool blocked = (*word == expected);
+    if(blocked)
+        sleep();
+    end_atomic();
+
+    return blocked;
+}
+
+
+unsigned int Futex::wakeup(unsigned int count)
+{
+    begin_atomic();
+    unsigned int n = 0;
+    for(; (n < count) && !_queue.empty(); n++)
+        Synchronizer_Common::wakeup();
+    end_atomic();
+
+    return n;
+}
+
+
+unsigned int Futex::key(volatile unsigned int * word)
+{
+    return Task::self()->address_space()->physical(const_cast<unsigned int *>(word));
+}
+
+
+// Futexes are kept once created: channels keep blocking on the same few words for as long as they exist
+Futex * Futex::get(unsigned int key, bool create)
+{
+    CPU::int_disable();
+    Element * e = _table.search_key(key);
+    CPU::int_enable();
+
+    if(e || !create)
+        return e ? e->object() : 0;
+
+    Futex * f = new (SYSTEM) Futex(key);
+
+    CPU::int_disable();
+    e = _table.search_key(key);
+    if(!e) {
+        e = &f->_link;
+        _table.insert(e);
+        f = 0;
+    }
+    CPU::int_enable();
+
+    if(f)
+        delete f;
+
+    return e->object();
+}
+
+__END_SYS
@@ -0,0 +1,79 @@
+// EPOS Threaded Interrupt Handler Implementation
+
+#include <process.h>
+
+__BEGIN_SYS
+
+// Class attributes
+IRQ_Thread::Table IRQ_Thread::_table;
+
+// Methods
+IRQ_Thread::IRQ_Thread(const Interrupt_Id & id, const Interrupt_Handler & handler, const Criterion & priority)
+: Thread(Configuration(SUSPENDED, priority), &body, this), _id(id), _handler(handler), _pending(0), _serviced(0), _irq_link(this, id)
+{
+    db<Thread>(TRC) << "IRQ_Thread(id=" << id << ",h=" << reinterpret_cast<void *>(handler) << ",prio=" << priority << ") => " << this << endl;
+
+    lock();
+    _table.insert(&_irq_link);
+    unlock();
+
+    IC::int_vector(id, &top_half);
+    IC::enable(id);
+}
+
+IRQ_Thread::~IRQ_Thread()
+{
+    db<Thread>(TRC) << "~IRQ_Thread(this=" << this << ",id=" << _id << ",serviced=" << _serviced << ")" << endl;
+
+    // The vector keeps pointing to top_half(), which ignores interrupts without a thread
+    IC::disable(_id);
+
+    lock();
+    _table.remove(&_irq_link);
+    unlock();
+}
+
+int IRQ_Thread::body(IRQ_Thread * t)
+{
+    for(;;) {
+        lock();
+        if(!t->_pending)
+            t->suspend(); // until top_half(); returns unlocked
+        else
+            unlock();
+
+        while(t->_pending) {
+            CPU::fdec(t->_pending);
+            t->_serviced++;
+            t->_handler(t->_id);
+        }
+
+        IC::enable(t->_id);
+    }
+
+    return 0;
+}
+
+void IRQ_Thread::top_half(Interrupt_Id id)
+{
+    lock();
+
+    Element * e = _table.search_key(id);
+    if(!e) {
+        unlock();
+        db<Thread>(WRN) << "IRQ_Thread::top_half(id=" << id << "): no handler thread!" << endl;
+        return;
+    }
+
+    // Keep the line masked until the bottom half has serviced the device
+    IC::disable(id);
+
+    IRQ_Thread * t = e->object();
+    t->_pending++;
+    if(t->_state == SUSPENDED)
+        t->resume(); // unlocks
+    else
+        unlock();
+}
+
+__END_SYS
@@ -1,6 +1,7 @@
 // EPOS Mutex Implementation
 
 #include <synchronizer.h>
+#include <tracer.h>
 
 __BEGIN_SYS
 
@@ -21,8 +22,10 @@ void Mutex::lock()
     db<Synchronizer>(TRC) << "Mutex::lock(this=" << this << ")" << endl;
 
     begin_atomic();
-    if(tsl(_locked))
+    if(tsl(_locked)) {
+        Tracer::trace<Synchronizer>(Tracer::MUTEX_CONTENTION, reinterpret_cast<unsigned long>(this));
         sleep();
+    }
     end_atomic();
 }
 
@@ -0,0 +1,63 @@
+// EPOS Palette Implementation
+
+#include <memory.h>
+
+__BEGIN_SYS
+
+// Class attributes
+unsigned int Palette::_taken;
+
+// Methods
+Palette Palette::take(unsigned int n)
+{
+    Palette palette;
+    unsigned int missing = n;
+
+    lock();
+    unsigned int left = ALL & ~_taken;
+    for(unsigned int c = COLOR_1; missing && (c < COLOR_1 + COLORS); c++)
+        if(left & (1 << c)) {
+            palette._colors |= 1 << c;
+            missing--;
+        }
+    if(missing)
+        palette._colors = 0;
+    _taken |= palette._colors;
+    unlock();
+
+    db<Segment>(TRC) << "Palette::take(n=" << n << ") => " << hex << palette._colors << endl;
+    if(missing)
+        db<Segment>(WRN) << "Palette::take(n=" << n << "): not enough colors left, falling back to best effort!" << endl;
+
+    return palette;
+}
+
+
+void Palette::release()
+{
+    db<Segment>(TRC) << "Palette::release(colors=" << hex << _colors << ")" << endl;
+
+    lock();
+    _taken &= ~_colors;
+    unlock();
+    _colors = 0;
+}
+
+
+Color Palette::color()
+{
+    lock();
+    unsigned int colors = _colors ? _colors : ALL & ~_taken;
+    unlock();
+
+    if(!colored() || !colors)
+        return WHITE;
+
+    do
+        _last = ((_last < COLOR_1) || (_last >= COLOR_1 + COLORS - 1)) ? COLOR_1 : _last + 1;
+    while(!(colors & (1 << _last)));
+
+    return static_cast<Color>(_last);
+}
+
+__END_SYS
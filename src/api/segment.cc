@@ -5,9 +5,9 @@
 __BEGIN_SYS
 
 // Methods
-Segment::Segment(unsigned int bytes, Flags flags): Chunk(bytes, flags, WHITE)
+Segment::Segment(unsigned int bytes, Flags flags, Color color): Chunk(bytes, flags, color)
 {
-    db<Segment>(TRC) << "Segment(bytes=" << bytes << ",flags=" << flags << ") [Chunk::pt=" << Chunk::pt() << ",sz=" << Chunk::size() << "] => " << this << endl;
+    db<Segment>(TRC) << "Segment(bytes=" << bytes << ",flags=" << flags << ",color=" << color << ") [Chunk::pt=" << Chunk::pt() << ",sz=" << Chunk::size() << "] => " << this << endl;
 }
 
 
@@ -19,6 +19,13 @@ Segment::Segment(Phy_Addr phy_addr, unsigned int bytes, Flags flags): Chunk(phy_
 }
 
 
+Segment::Segment(unsigned int bytes, Flags flags, Color color, bool populated): Chunk(bytes, flags, color, populated)
+// Unpopulated pages get frames later through share() and populate() (e.g. by Task::load())
+{
+    db<Segment>(TRC) << "Segment(bytes=" << bytes << ",flags=" << flags << ",populated=" << populated << ",color=" << color << ") [Chunk::pt=" << Chunk::pt() << ",sz=" << Chunk::size() << "] => " << this << endl;
+}
+
+
 Segment::~Segment()
 {
     db<Segment>(TRC) << "~Segment() [Chunk::pt=" << Chunk::pt() << "]" << endl;
@@ -44,4 +51,26 @@ int Segment::resize(int amount)
     return Chunk::resize(amount);
 }
 
+
+void Segment::share(unsigned int offset, Phy_Addr frame)
+{
+    db<Segment>(TRC) << "Segment::share(offset=" << offset << ",frame=" << frame << ")" << endl;
+
+    Chunk::share(offset / sizeof(MMU::Page), frame);
+}
+
+
+Segment::Phy_Addr Segment::populate(unsigned int offset, Color color)
+{
+    db<Segment>(TRC) << "Segment::populate(offset=" << offset << ",color=" << color << ")" << endl;
+
+    return Chunk::populate(offset / sizeof(MMU::Page), color);
+}
+
+
+Segment::Phy_Addr Segment::frame(unsigned int offset) const
+{
+    return Chunk::frame(offset / sizeof(MMU::Page));
+}
+
 __END_SYS
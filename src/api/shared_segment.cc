@@ -1,30 +1,146 @@
-// EPOS Component Declarations
-
+// EPOS Shared_Segment Implementation
 
 #include <system.h>
 #include <memory.h>
 
 __BEGIN_SYS
 
-Shared_Segment::SS_List Shared_Segment::_shared_segments;
+// Class attributes
+Shared_Segment::Registry Shared_Segment::_registry;
+
+// Methods
+// Pages are zero-filled, so peers can agree on the initial state of whatever they lay out in the segment (e.g. channels)
+Shared_Segment::Shared_Segment(int port, unsigned int bytes)
+: Segment(bytes, Segment::Flags(Segment::Flags::APPD), WHITE, false), _port(port), _references(0), _link(this, port)
+{
+    db<Segment>(TRC) << "Shared_Segment(port=" << port << ",bytes=" << bytes << ") => " << this << endl;
+
+    for(unsigned int offset = 0; offset < size(); offset += sizeof(MMU::Page))
+        populate(offset);
+}
+
+// The registry entry is removed along with the last reference, so the destructor has nothing left to unbind
+Shared_Segment::~Shared_Segment()
+{
+    db<Segment>(TRC) << "~Shared_Segment(this=" << this << ",port=" << _port << ")" << endl;
+}
+
+Shared_Segment * Shared_Segment::get(Address_Space * as, int port, unsigned int bytes)
+{
+    return acquire(as, port, bytes, false);
+}
+
+bool Shared_Segment::put(Address_Space * as, Shared_Segment * seg)
+{
+    db<Segment>(TRC) << "Shared_Segment::put(as=" << as << ",seg=" << seg << ")" << endl;
 
-Shared_Segment::Shared_Segment(int port, unsigned int bytes): Segment(bytes, MMU::Flags::APPD) {
+    if(!release(as, seg, false))
+        return false;
 
-    db<Segment>(TRC) << "Shared Memory Created" << endl;
-    _port = port;
-    SS_List::Element * e_shared_segment = new (SYSTEM) SS_List::Element(this);
-    _shared_segments.insert(e_shared_segment);
+    seg->unreference();
+
+    return true;
+}
+
+Shared_Segment::Log_Addr Shared_Segment::attach(Address_Space * as, int port, unsigned int bytes)
+{
+    Shared_Segment * seg = acquire(as, port, bytes, true);
+    Log_Addr addr = as->attach(seg);
+    if(!addr && release(as, seg, true))
+        seg->unreference();
+
+    db<Segment>(TRC) << "Shared_Segment::attach(as=" << as << ",port=" << port << ") => " << addr << endl;
+
+    return addr;
 }
 
-Shared_Segment * Shared_Segment::using_port(int port) {
-    SS_List::Element * e = _shared_segments.head();
-    for(; e && (e->object()->get_port() != port); e = e->next());
-    if (e) {
-        db<Segment>(TRC) << "FOUND Port "<< port << " in " << e->object() << endl;
-        return e->object();
+bool Shared_Segment::detach(Address_Space * as, int port)
+{
+    db<Segment>(TRC) << "Shared_Segment::detach(as=" << as << ",port=" << port << ")" << endl;
+
+    Shared_Segment * seg = using_port(port);
+    if(!seg || !release(as, seg, true))
+        return false;
+
+    // The reference dropped only below keeps the segment alive while it is detached
+    as->detach(seg);
+    seg->unreference();
+
+    return true;
+}
+
+// Takes a reference to the segment bound to port (creating it if needed) and records as as its holder
+Shared_Segment * Shared_Segment::acquire(Address_Space * as, int port, unsigned int bytes, bool attaching)
+{
+    Holders::Element * holder = new (SYSTEM) Holders::Element(as);
+
+    lock();
+    Element * e = _registry.search_key(port);
+    if(!e) {
+        // Segments are created outside the critical section, so another get() might have bound the port meanwhile
+        unlock();
+        Shared_Segment * seg = new (SYSTEM) Shared_Segment(port, bytes);
+        lock();
+        e = _registry.search_key(port);
+        if(!e) {
+            e = &seg->_link;
+            _registry.insert(e);
+        } else {
+            unlock();
+            delete seg;
+            lock();
+        }
     }
-    return 0;
+    Shared_Segment * seg = e->object();
+    seg->_references++;
+    (attaching ? seg->_attachments : seg->_holders).insert(holder);
+    unlock();
+
+    db<Segment>(TRC) << "Shared_Segment::acquire(as=" << as << ",port=" << port << ",bytes=" << bytes << ") => " << seg << " [refs=" << seg->_references << "]" << endl;
+
+    return seg;
 }
 
-__END_SYS
+// Forgets one reference as holds to seg, returning seg if there was one. Tasks that never took a reference (or that
+// already dropped it) cannot drop anybody else's, nor name a segment that is no longer registered.
+Shared_Segment * Shared_Segment::release(Address_Space * as, Shared_Segment * seg, bool attached)
+{
+    lock();
+    Holders::Element * holder = _registry.search(seg) ? (attached ? seg->_attachments : seg->_holders).remove(as) : 0;
+    unlock();
+
+    if(!holder) {
+        db<Segment>(WRN) << "Shared_Segment::release(as=" << as << ",seg=" << seg << "): no such reference!" << endl;
+        return 0;
+    }
+    delete holder;
+
+    return seg;
+}
 
+// Drops a reference released above. The last one unbinds the port under the same lock, so no get() can revive the
+// segment while it is being deleted.
+void Shared_Segment::unreference()
+{
+    lock();
+    bool last = !--_references;
+    if(last)
+        _registry.remove(&_link);
+    unlock();
+
+    db<Segment>(TRC) << "Shared_Segment::unreference(this=" << this << ",port=" << _port << ") [refs=" << _references << "]" << endl;
+
+    if(last)
+        delete this;
+}
+
+Shared_Segment * Shared_Segment::using_port(int port)
+{
+    lock();
+    Element * e = _registry.search_key(port);
+    unlock();
+
+    return e ? e->object() : 0;
+}
+
+__END_SYS
@@ -3,14 +3,17 @@
 #include <system.h>
 #include <time.h>
 #include <process.h>
+#include <tracer.h>
 
 __BEGIN_SYS
 
 void System::init()
 {
+    Boot_Tracer::stamp(Boot_Trace::ALARM_INIT);
     if(Traits<Alarm>::enabled)
         Alarm::init();
 
+    Boot_Tracer::stamp(Boot_Trace::THREAD_INIT);
     if(Traits<Thread>::enabled)
         Thread::init();
 }
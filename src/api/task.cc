@@ -1,6 +1,8 @@
 // EPOS Task Implementation
 
 #include <process.h>
+#include <utility/elf.h>
+#include <tracer.h>
 
 __BEGIN_SYS
 
@@ -22,6 +24,111 @@ Task::~Task()
     unlock();
 
     delete _as;
+
+    _palette.release();
+}
+
+
+// Called by Thread::dispatch() on the first dispatch of the task's main thread, which is as close to the application's
+// main() as the kernel gets. The stamps are only printed when the last thread exits (see Boot_Tracer::report_tasks()).
+void Task::boot_trace()
+{
+    Boot_Tracer::stamp(_id, _loaded);
+    _loaded = 0;
+}
+
+
+// Creates a Task out of an ELF image that is present in the current address space (e.g. an application appended to the
+// boot image by eposmkbi). Whenever a read-only PT_LOAD page of the image is page-aligned, its frame is mapped straight
+// into the new task instead of being copied. Writable pages are always copied, since the image stays mapped in the
+// loader, which could otherwise keep writing into the new task's data. The .bss tail and the heap get fresh, zero-filled
+// frames. The image must not be reused after it has been loaded.
+// While cache colors are in use (see Palette), every page gets a frame from the task's palette instead, one color after
+// the other, so code, data and heap are spread over all the colors of the task and images are always copied.
+Task * Task::load(const Log_Addr & image, unsigned int heap_size, unsigned int colors)
+{
+    db<Task>(TRC) << "Task::load(image=" << image << ",heap=" << heap_size << ",colors=" << colors << ")" << endl;
+
+    ELF * elf = image;
+    if(!elf->valid()) {
+        db<Task>(WRN) << "Task::load: corrupted ELF image at " << image << "!" << endl;
+        return 0;
+    }
+
+    Log_Addr code = elf->segment_address(0);
+    unsigned int code_size = elf->segment_size(0);
+
+    Elf32_Addr data_low = ~0U;
+    Elf32_Addr data_high = 0;
+    for(int i = 1; i < elf->segments(); i++) {
+        if(elf->segment_type(i) != PT_LOAD)
+            continue;
+        if(elf->segment_vaddr(i) < data_low)
+            data_low = elf->segment_vaddr(i);
+        if(elf->segment_vaddr(i) + elf->segment_memory_size(i) > data_high)
+            data_high = elf->segment_vaddr(i) + elf->segment_memory_size(i);
+    }
+    if(data_low == ~0U)
+        data_low = data_high = Memory_Map::APP_DATA;
+
+    // Segments are attached at page table (i.e. directory) boundaries
+    Log_Addr data = data_low & ~(MMU::PT_ENTRIES * sizeof(MMU::Page) - 1);
+    unsigned int data_size = MMU::align_page(data_high - data) + MMU::align_page(heap_size);
+
+    Palette palette = Palette::take(colors);
+
+    Segment * cs = new (SYSTEM) Segment(code_size, Segment::Flags(Segment::Flags::APPC), palette.color(), false);
+    Segment * ds = new (SYSTEM) Segment(data_size, Segment::Flags(Segment::Flags::APPD), palette.color(), false);
+
+    for(int i = 0; i < elf->segments(); i++)
+        if(elf->segment_type(i) == PT_LOAD)
+            load_segment(i ? ds : cs, i ? data : code, elf, image, i, palette);
+
+    // Whatever is left (gaps and heap) gets zeroed frames
+    for(unsigned int offset = 0; offset < code_size; offset += sizeof(MMU::Page))
+        if(!cs->frame(offset))
+            cs->populate(offset, palette.color());
+    for(unsigned int offset = 0; offset < data_size; offset += sizeof(MMU::Page))
+        if(!ds->frame(offset))
+            ds->populate(offset, palette.color());
+
+    typedef int (Main)();
+    return new (SYSTEM) Task(palette, cs, ds, reinterpret_cast<Main *>(elf->entry()), code, data);
+}
+
+void Task::load_segment(Segment * seg, const Log_Addr & base, ELF * elf, const Log_Addr & image, int i, Palette & palette)
+{
+    Address_Space * self = current()->address_space();
+
+    bool writable = elf->segment_flags(i) & PF_W;
+    Elf32_Addr vaddr = elf->segment_vaddr(i);
+    Elf32_Addr file_top = vaddr + elf->segment_file_size(i);
+    Elf32_Addr mem_top = vaddr + elf->segment_memory_size(i);
+    Elf32_Addr src = Elf32_Addr(image) + elf->segment_offset(i); // where vaddr is in the image
+
+    db<Task>(TRC) << "Task::load_segment(seg=" << seg << ",i=" << i << ",vaddr=" << reinterpret_cast<void *>(vaddr)
+                  << ",src=" << reinterpret_cast<void *>(src) << ",filesz=" << file_top - vaddr << ",memsz=" << mem_top - vaddr << ")" << endl;
+
+    for(Elf32_Addr page = MMU::indexes(vaddr); page < mem_top; page += sizeof(MMU::Page)) {
+        unsigned int offset = page - base;
+        Elf32_Addr from = (page < vaddr) ? vaddr : page;
+        Elf32_Addr to = (page + sizeof(MMU::Page) < file_top) ? page + sizeof(MMU::Page) : file_top;
+
+        if(from >= to) { // .bss
+            seg->populate(offset, palette.color());
+            continue;
+        }
+
+        // Read-only pages can be shared as long as there is no .bss to clear in them
+        Elf32_Addr image_page = src - (vaddr - page);
+        bool aligned = !MMU::offset(image_page);
+        if(aligned && !writable && !palette.colored() && !seg->frame(offset) && ((to == page + sizeof(MMU::Page)) || (file_top == mem_top)))
+            seg->share(offset, MMU::indexes(self->physical(image_page)));
+        else {
+            Phy_Addr frame = seg->populate(offset, palette.color());
+            memcpy(MMU::phy2log(frame) + MMU::offset(from), reinterpret_cast<void *>(src + (from - vaddr)), to - from);
+        }
+    }
 }
 
 __END_SYS
@@ -3,6 +3,7 @@
 #include <machine.h>
 #include <system.h>
 #include <process.h>
+#include <tracer.h>
 
 // This_Thread class attributes
 __BEGIN_UTIL
@@ -12,6 +13,8 @@ __END_UTIL
 __BEGIN_SYS
 
 volatile unsigned int Thread::_thread_count;
+volatile bool Thread::_in_interrupt[];
+volatile bool Thread::_reschedule_deferred[];
 Scheduler_Timer * Thread::_timer;
 Scheduler<Thread> Thread::_scheduler;
 
@@ -307,6 +310,12 @@ void Thread::reschedule()
 
     assert(locked()); // locking handled by caller
 
+    unsigned int cpu = CPU::id();
+    if(_in_interrupt[cpu]) {
+        _reschedule_deferred[cpu] = true;
+        return;
+    }
+
     Thread * prev = running();
     Thread * next = _scheduler.choose();
 
@@ -314,6 +323,19 @@ void Thread::reschedule()
 }
 
 
+void Thread::int_leave()
+{
+    assert(locked()); // locking handled by caller
+
+    unsigned int cpu = CPU::id();
+    _in_interrupt[cpu] = false;
+    if(_reschedule_deferred[cpu]) {
+        _reschedule_deferred[cpu] = false;
+        reschedule();
+    }
+}
+
+
 void Thread::time_slicer(IC::Interrupt_Id i)
 {
     lock();
@@ -337,6 +359,7 @@ void Thread::dispatch(Thread * prev, Thread * next, bool charge)
         next->_state = RUNNING;
 
         db<Thread>(TRC) << "Thread::dispatch(prev=" << prev << ",next=" << next << ")" << endl;
+        Tracer::trace<Thread>(Tracer::THREAD_DISPATCH, reinterpret_cast<unsigned long>(prev), reinterpret_cast<unsigned long>(next));
         if(Traits<Thread>::debugged) {
             CPU::Context tmp;
             tmp.save();
@@ -348,6 +371,9 @@ void Thread::dispatch(Thread * prev, Thread * next, bool charge)
             next->_task->activate_context();
         }
 
+        if(Traits<Tracer>::boot_trace && (next == next->_task->_main) && next->_task->_loaded)
+            next->_task->boot_trace();
+
         // The non-volatile pointer to volatile pointer to a non-volatile context is correct
         // and necessary because of context switches, but here, we are locked() and
         // passing the volatile to switch_constext forces it to push prev onto the stack,
@@ -367,11 +393,22 @@ int Thread::idle()
             db<Thread>(TRC) << "Thread::idle(this=" << running() << ")" << endl;
 
         CPU::int_enable();
+        if(Traits<Debug>::buffered && (CPU::id() == 0)) // the log ring has a single consumer
+            System::flush();
         CPU::halt();
     }
 
     CPU::int_disable();
     db<Thread>(WRN) << "The last thread has exited!" << endl;
+    if(Traits<Tracer>::enabled)
+        Tracer::dump();
+    if(Traits<Tracer>::irq_profile)
+        IRQ_Profiler::report();
+    if(Traits<Tracer>::int_off_profile)
+        Int_Off_Profiler::report();
+    if(Traits<Tracer>::boot_trace)
+        Boot_Tracer::report_tasks();
+    System::flush();
     if(reboot) {
         db<Thread>(WRN) << "Rebooting the machine ..." << endl;
         Machine::reboot();
@@ -0,0 +1,192 @@
+// EPOS Binary Event Tracer Implementation
+
+#include <tracer.h>
+#include <system.h>
+
+__BEGIN_SYS
+
+// Class attributes
+volatile unsigned int Tracer::_next;
+Tracer::Record Tracer::_records[];
+IRQ_Profiler::Profile IRQ_Profiler::_profiles[];
+Int_Off_Profiler::Cycles Int_Off_Profiler::_start[];
+void * Int_Off_Profiler::_site[];
+Int_Off_Profiler::Site Int_Off_Profiler::_worst[][Int_Off_Profiler::SITES];
+
+// Methods
+void Tracer::dump()
+{
+    unsigned int next = _next;
+    unsigned int count = (next < RECORDS) ? next : RECORDS;
+
+    db<Tracer>(TRC) << "Tracer::dump(records=" << count << ",lost=" << next - count << ")" << endl;
+
+    // One record per line, oldest first: time event cpu thread a b
+    kout << "#TRACE " << TSC::frequency() << " " << count << endl;
+    for(unsigned int i = next - count; i != next; i++) {
+        const Record & r = _records[i % RECORDS];
+        kout << r.time << " " << r.event << " " << r.cpu << " " << r.thread << " " << r.a << " " << r.b << endl;
+        System::flush();
+    }
+    kout << "#END" << endl;
+    System::flush();
+}
+
+
+bool IRQ_Profiler::profile(unsigned int id, Profile * p)
+{
+    db<Tracer>(TRC) << "IRQ_Profiler::profile(id=" << id << ",p=" << p << ")" << endl;
+
+    if(!Traits<Tracer>::irq_profile || (id >= INTS))
+        return false;
+
+    bool do_int = CPU::int_enabled();
+    CPU::int_disable();
+    *p = _profiles[id];
+    if(do_int)
+        CPU::int_enable();
+
+    return true;
+}
+
+void IRQ_Profiler::report()
+{
+    if(!Traits<Tracer>::irq_profile)
+        return;
+
+    kout << "Interrupt profile (PMU cycles; bucket i counts samples in [2^i, 2^(i+1))):" << endl;
+    for(unsigned int i = 0; i < INTS; i++) {
+        const Profile & p = _profiles[i];
+        if(!p.count)
+            continue;
+
+        kout << "IRQ " << i << ": count=" << p.count << ", max latency=" << p.max_latency << ", max handler=" << p.max_handler << endl;
+        kout << "  latency:";
+        for(unsigned int b = 0; b < BUCKETS; b++)
+            kout << " " << p.latency[b];
+        kout << endl << "  handler:";
+        for(unsigned int b = 0; b < BUCKETS; b++)
+            kout << " " << p.handler[b];
+        kout << endl;
+        System::flush();
+    }
+    System::flush();
+}
+
+
+void Int_Off_Profiler::report()
+{
+    if(!Traits<Tracer>::int_off_profile)
+        return;
+
+    // Printing goes through int_disable() and int_enable() itself, so work on a snapshot
+    Site worst[CPUS][SITES];
+    for(unsigned int c = 0; c < CPUS; c++)
+        for(unsigned int i = 0; i < SITES; i++)
+            worst[c][i] = _worst[c][i];
+
+    kout << "Longest interrupt-disabled intervals (PMU cycles on Cortex-A, TSC ticks elsewhere):" << endl;
+    for(unsigned int c = 0; c < CPUS; c++) {
+        // Selection sort by decreasing max
+        for(unsigned int i = 0; i < SITES; i++) {
+            unsigned int k = i;
+            for(unsigned int j = i + 1; j < SITES; j++)
+                if(worst[c][j].max > worst[c][k].max)
+                    k = j;
+            Site tmp = worst[c][i];
+            worst[c][i] = worst[c][k];
+            worst[c][k] = tmp;
+        }
+
+        for(unsigned int i = 0; (i < SITES) && worst[c][i].address; i++)
+            kout << "CPU " << c << ": site=" << worst[c][i].address << ", max=" << worst[c][i].max << ", count=" << worst[c][i].count << endl;
+        System::flush();
+    }
+}
+
+
+void Boot_Tracer::stamp(Boot_Trace::Phase phase)
+{
+    if(!Traits<Tracer>::boot_trace || !Traits<System>::multitask || (CPU::id() != 0))
+        return;
+
+    Boot_Trace * bt = &System::info()->bt;
+    bt->frequency = TSC::frequency();
+    bt->stamp(phase, TSC::time_stamp());
+}
+
+// Only stores the stamps, since it runs in Thread::dispatch() with interrupts disabled
+void Boot_Tracer::stamp(unsigned int task, unsigned int created)
+{
+    if(!Traits<Tracer>::boot_trace || !Traits<System>::multitask)
+        return;
+
+    System::info()->bt.stamp(task, created, TSC::time_stamp());
+}
+
+bool Boot_Tracer::trace(Boot_Trace * t)
+{
+    if(!Traits<Tracer>::boot_trace || !Traits<System>::multitask)
+        return false;
+
+    *t = System::info()->bt;
+
+    return true;
+}
+
+void Boot_Tracer::report()
+{
+    if(!Traits<Tracer>::boot_trace || !Traits<System>::multitask)
+        return;
+
+    const Boot_Trace & bt = System::info()->bt;
+    unsigned int mhz = bt.frequency / 1000000;
+
+    kout << "Boot trace (TSC at " << bt.frequency << " Hz; each phase lasts until the next one):" << endl;
+    unsigned int first = Boot_Trace::PHASES;
+    for(unsigned int i = 0; i < Boot_Trace::PHASES; i++) {
+        if(!bt.has(i))
+            continue;
+        if(first == Boot_Trace::PHASES)
+            first = i;
+
+        unsigned int next = i + 1;
+        while((next < Boot_Trace::PHASES) && !bt.has(next))
+            next++;
+        if(next == Boot_Trace::PHASES)
+            break;
+
+        unsigned int ticks = bt.time_stamp[next] - bt.time_stamp[i]; // 32-bit stamps, so wrap-arounds cancel out
+        kout << "  " << Boot_Trace::name(i) << ": " << ticks << " ticks";
+        if(mhz)
+            kout << " (" << ticks / mhz << " us)";
+        kout << endl;
+    }
+    if((first < Boot_Trace::INIT_END) && bt.has(Boot_Trace::INIT_END)) {
+        unsigned int ticks = bt.time_stamp[Boot_Trace::INIT_END] - bt.time_stamp[first];
+        kout << "  total since " << Boot_Trace::name(first) << ": " << ticks << " ticks";
+        if(mhz)
+            kout << " (" << ticks / mhz << " us)";
+        kout << endl;
+    }
+    System::flush();
+}
+
+// TSC counts since reset, so both times are absolute boot times
+void Boot_Tracer::report_tasks()
+{
+    if(!Traits<Tracer>::boot_trace || !Traits<System>::multitask)
+        return;
+
+    const Boot_Trace & bt = System::info()->bt;
+    unsigned int mhz = bt.frequency / 1000000;
+    if(!mhz)
+        return;
+
+    for(unsigned int i = 0; i < Boot_Trace::TASKS; i++)
+        if(bt.has_task(i))
+            kout << "Boot: task " << i << " created at " << bt.task[i].created / mhz << " us, main() at " << bt.task[i].started / mhz << " us" << endl;
+    System::flush();
+}
+
+__END_SYS
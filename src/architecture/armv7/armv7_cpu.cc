@@ -1,6 +1,7 @@
 // EPOS ARMv7 CPU Mediator Implementation
 
 #include <architecture/armv7/armv7_cpu.h>
+#include <tracer.h>
 
 __BEGIN_SYS
 
@@ -43,6 +44,7 @@ if(thumb)
 
 void CPU::Context::load() const volatile
 {
+    int_off_discard();
     ASM("       mov     sp, %0                  \n"
         "       isb                             \n" : : "r"(this)); // serialize the pipeline so that SP gets updated before the pop
     ASM(
@@ -102,11 +104,28 @@ if(Traits<FPU>::enabled && !Traits<FPU>::user_save)
 
     ASM("       pop     {r0-r12, lr}            \n");   // pop all registers (r0 first, LR last)
 
+// The plain instruction, since the profiling hook in int_enable() is a call that would clobber the registers just popped
 if((Traits<Build>::MODEL == Traits<Build>::eMote3) || (Traits<Build>::MODEL == Traits<Build>::LM3S811))
-    int_enable();
+    Base::int_enable();
 
     ASM("       pop     {pc}                    \n"     // restore PC
         ".ret:  bx      lr                      \n");   // return
 }
 
+// Interrupt-off profiling hooks (the caller's return address is the site that disabled the interrupts)
+void CPU::int_off_begin()
+{
+    Int_Off_Profiler::begin(__builtin_return_address(0));
+}
+
+void CPU::int_off_end()
+{
+    Int_Off_Profiler::end();
+}
+
+void CPU::int_off_clear()
+{
+    Int_Off_Profiler::discard();
+}
+
 __END_SYS
@@ -10,7 +10,9 @@ void ARMv7_MMU::init()
     db<Init, MMU>(TRC) << "MMU::init()" << endl;
     db<Init, MMU>(INF) << "MMU::init()" << System::info() << hex << ", base=" << System::info()->pmm.free1_base << ", top=" << System::info()->pmm.free1_top << endl;
     free(System::info()->pmm.free1_base, pages(System::info()->pmm.free1_top - System::info()->pmm.free1_base));
-   
+    if(System::info()->pmm.free2_top > System::info()->pmm.free2_base) // the boot image extras are mapped in place in between
+        free(System::info()->pmm.free2_base, pages(System::info()->pmm.free2_top - System::info()->pmm.free2_base));
+
     // Remember the master page directory (created during SETUP)
     _master = current();
     db<Init, MMU>(INF) << "MMU::master page directory=" << _master << endl;
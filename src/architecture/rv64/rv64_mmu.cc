@@ -4,7 +4,9 @@
 
 __BEGIN_SYS
 
-RV32S_MMU::List RV32S_MMU::_free[colorful * COLORS + 1];
-RV32S_MMU::Page_Directory * RV32S_MMU::_master;
+SV39_MMU::List SV39_MMU::_free[colorful * COLORS + 1];
+SV39_MMU::Page_Directory * SV39_MMU::_master;
+unsigned int SV39_MMU::_asids;
+unsigned int SV39_MMU::_asid_map[ASIDS / 32];
 
 __END_SYS
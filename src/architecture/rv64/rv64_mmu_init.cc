@@ -5,12 +5,25 @@
 
 __BEGIN_SYS
 
-void RV32S_MMU::init()
+void SV39_MMU::init()
 {
     db<Init, MMU>(TRC) << "MMU::init()" << endl;
 
     free(System::info()->pmm.free1_base, pages(System::info()->pmm.free1_top - System::info()->pmm.free1_base));
+
+    // Remember the master page directory (created during SETUP)
+    _master = current();
+    db<Init, MMU>(INF) << "MMU::master page directory=" << _master << endl;
+
+    // ASID bits are WARL: write all ones and read back how many the hart implements (possibly none)
+    CPU::pdp(Phy_Addr(_master), CPU::SATP_ASID >> CPU::SATP_ASID_SHIFT);
+    unsigned int implemented = CPU::asid() + 1;
+    CPU::pdp(Phy_Addr(_master));
+    flush_tlb();
+
+    _asids = (implemented < ASIDS) ? implemented : ASIDS;
+    _asid_map[0] = 1; // ASID 0 belongs to the master directory
+    db<Init, MMU>(INF) << "MMU::ASIDs=" << _asids << " (hart implements " << implemented << ")" << endl;
 }
 
 __END_SYS
-
@@ -3,6 +3,7 @@
 #include <system.h>
 #include <machine.h>
 #include <utility/string.h>
+#include <tracer.h>
 
 extern "C" char __bss_start;    // defined by GCC
 extern "C" char _end;           // defined by GCC
@@ -19,6 +20,8 @@ public:
 	if(CPU::id() == 0)
             memset(reinterpret_cast<void *>(__bss_start), 0, _end - __bss_start);
 
+        Boot_Tracer::stamp(Boot_Trace::INIT);
+
         Machine::pre_init(System::info());
     }
 };
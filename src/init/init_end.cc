@@ -2,6 +2,7 @@
 
 #include <system.h>
 #include <process.h>
+#include <tracer.h>
 
 __BEGIN_SYS
 
@@ -15,6 +16,11 @@ public:
     Init_End() {
         db<Init>(TRC) << "Init_End()" << endl;
 
+        if(Traits<Tracer>::boot_trace && (CPU::id() == 0)) {
+            Boot_Tracer::stamp(Boot_Trace::INIT_END);
+            Boot_Tracer::report();
+        }
+
         if(!Traits<System>::multithread) {
             CPU::int_enable();
             return;
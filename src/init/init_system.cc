@@ -5,6 +5,7 @@
 #include <memory.h>
 #include <system.h>
 #include <process.h>
+#include <tracer.h>
 
 __BEGIN_SYS
 
@@ -17,10 +18,12 @@ public:
     Init_System() {
         db<Init>(TRC) << "Init_System()" << endl;
 
+        Boot_Tracer::stamp(Boot_Trace::CPU_INIT);
         db<Init>(INF) << "Initializing the CPU: " << endl;
         CPU::init();
         db<Init>(INF) << "done!" << endl;
 
+        Boot_Tracer::stamp(Boot_Trace::HEAP_INIT);
         db<Init>(INF) << "Initializing system's heap: " << endl;
         if(Traits<System>::multiheap) {
             System::_heap_segment = new (&System::_preheap[0]) Segment(HEAP_SIZE, Segment::Flags::SYS);
@@ -32,10 +35,12 @@ public:
             System::_heap = new (&System::_preheap[0]) Heap(MMU::alloc(MMU::pages(HEAP_SIZE)), HEAP_SIZE);
         db<Init>(INF) << "done!" << endl;
 
+        Boot_Tracer::stamp(Boot_Trace::MACHINE_INIT);
         db<Init>(INF) << "Initializing the machine: " << endl;
         Machine::init();
         db<Init>(INF) << "done!" << endl;
 
+        Boot_Tracer::stamp(Boot_Trace::SYSTEM_INIT);
         db<Init>(INF) << "Initializing system abstractions: " << endl;
         System::init();
         db<Init>(INF) << "done!" << endl;
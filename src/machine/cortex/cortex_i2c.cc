@@ -0,0 +1,144 @@
+// EPOS ARM Cortex I2C Mediator Implementation
+
+#include <system.h>
+#include <machine/ic.h>
+#include <machine/i2c.h>
+#include <synchronizer.h>
+
+#ifdef __I2C_H
+
+__BEGIN_SYS
+
+// Class attributes
+I2C * I2C::_devices[UNITS];
+I2C::Transfer I2C::_transfers[UNITS];
+
+// Methods
+bool I2C::transfer(const Segment * list, unsigned int n, Callback * callback, void * data)
+{
+    db<I2C>(TRC) << "I2C::transfer(unit=" << _unit << ",list=" << list << ",n=" << n << ")" << endl;
+
+    for(unsigned int i = 0; i < n; i++)
+        if(!list[i].size)
+            return false;
+
+    Transfer & t = open();
+
+    CPU::int_disable();
+    if(!n || t.busy) {
+        CPU::int_enable();
+        return false;
+    }
+    t.list = list;
+    t.n = n;
+    t.segment = 0;
+    t.done = 0;
+    t.ok = true;
+    t.callback = callback;
+    t.data = data;
+    t.busy = true;
+    begin(list[0], n == 1);
+    CPU::int_enable();
+
+    return true;
+}
+
+bool I2C::wait()
+{
+    Transfer & t = _transfers[_unit];
+
+    CPU::int_disable();
+    if(t.busy) {
+        t.waiting = true;
+        CPU::int_enable();
+        t.finished->p();
+    } else
+        CPU::int_enable();
+
+    return t.ok;
+}
+
+I2C::Transfer & I2C::open()
+{
+    Transfer & t = _transfers[_unit];
+
+    if(!_devices[_unit]) {
+        db<I2C>(TRC) << "I2C::open(unit=" << _unit << ")" << endl;
+
+        t.finished = new (SYSTEM) Semaphore(0);
+
+        // The handlers need an engine that outlives this object
+        _devices[_unit] = new (SYSTEM) I2C(*this);
+
+        IC::Interrupt_Id id = interrupt();
+        IC::disable(id);
+        IC::int_vector(id, int_handler);
+        IC::eoi_vector(id, eoi);
+        int_master(true);
+        IC::enable(id);
+    }
+
+    return t;
+}
+
+// Completes the byte in flight and issues the next one; called with interrupts disabled
+void I2C::service(unsigned int unit)
+{
+    I2C * i2c = _devices[unit];
+    Transfer & t = _transfers[unit];
+
+    if(!i2c || !i2c->int_pending() || !t.busy)
+        return;
+
+    const Segment & s = t.list[t.segment];
+    bool last = (t.segment == t.n - 1);
+    int done = i2c->step(s, t.done, last);
+    if(done < 0) {
+        t.ok = false;
+        t.busy = false;
+    } else if(static_cast<unsigned int>(done) < s.size)
+        t.done = done;
+    else if(!last) {
+        t.segment++;
+        t.done = 0;
+        i2c->begin(t.list[t.segment], t.segment == t.n - 1);
+    } else
+        t.busy = false;
+}
+
+// Runs before interrupts are re-enabled, so the (level-triggered) request is cleared before the handler is called
+void I2C::eoi(IC::Interrupt_Id id)
+{
+    for(unsigned int i = 0; i < UNITS; i++)
+        service(i);
+}
+
+void I2C::int_handler(IC::Interrupt_Id id)
+{
+    for(unsigned int i = 0; i < UNITS; i++) {
+        Transfer & t = _transfers[i];
+
+        CPU::int_disable();
+        service(i); // on ICs that do not call eoi() before dispatching
+        Callback * callback = 0;
+        void * data = t.data;
+        bool ok = t.ok;
+        bool waiting = false;
+        if(!t.busy) {
+            callback = t.callback;
+            t.callback = 0;
+            waiting = t.waiting;
+            t.waiting = false;
+        }
+        CPU::int_enable();
+
+        if(callback)
+            callback(ok, data);
+        if(waiting)
+            t.finished->v();
+    }
+}
+
+__END_SYS
+
+#endif
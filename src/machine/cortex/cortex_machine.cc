@@ -2,14 +2,17 @@
 
 #include <machine/machine.h>
 #include <machine/display.h>
+#include <system.h>
 
 __BEGIN_SYS
 
 void Machine::panic()
 {
     CPU::int_disable();
-    if(Traits<Display>::enabled)
+    if(Traits<Display>::enabled) {
+        System::flush();
         Display::puts("PANIC!\n");
+    }
     if(Traits<System>::reboot)
         reboot();
     else
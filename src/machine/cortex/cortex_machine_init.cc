@@ -1,6 +1,7 @@
 // EPOS Cortex Initialization
 
 #include <machine.h>
+#include <tracer.h>
 
 __BEGIN_SYS
 
@@ -31,14 +32,21 @@ void Machine::init()
 
     Engine::init();
 
+    Boot_Tracer::stamp(Boot_Trace::TIMER_INIT);
     if(Traits<Timer>::enabled)
         Timer::init();
 
+    Boot_Tracer::stamp(Boot_Trace::DEVICES_INIT);
 #ifdef __USB_H
     if(Traits<USB>::enabled)
         USB::init();
 #endif
 
+#ifdef __SPI_H
+    if(Traits<SPI>::enabled)
+        SPI::init();
+#endif
+
 #ifdef __NIC_H
 #ifdef __ethernet__
     if(Traits<Ethernet>::enabled)
@@ -0,0 +1,127 @@
+// EPOS ARM Cortex SPI Mediator Implementation
+
+#include <system.h>
+#include <machine/ic.h>
+#include <machine/spi.h>
+#include <synchronizer.h>
+
+#ifdef __SPI_H
+
+__BEGIN_SYS
+
+// Class attributes
+SPI * SPI::_devices[UNITS];
+SPI::DMA SPI::_dma[UNITS];
+
+// Methods
+bool SPI::transfer(const Segment * list, unsigned int n, Callback * callback, void * data)
+{
+    db<SPI>(TRC) << "SPI::transfer(unit=" << _unit << ",list=" << list << ",n=" << n << ")" << endl;
+
+    if(!Traits<SPI>::dma)
+        return false;
+
+    DMA & d = open();
+
+    CPU::int_disable();
+    if(d.busy) {
+        CPU::int_enable();
+        return false;
+    }
+    d.callback = callback;
+    d.data = data;
+    d.busy = dma_start(list, n, d.rx, d.tx, d.dummy);
+    CPU::int_enable();
+
+    if(!d.busy)
+        db<SPI>(WRN) << "SPI::transfer: list too long (max " << DMA_TASKS << " tasks of " << UDMA::MAX_TRANSFER << " bytes)!" << endl;
+
+    return d.busy;
+}
+
+void SPI::wait()
+{
+    DMA & d = _dma[_unit];
+
+    CPU::int_disable();
+    if(d.busy) {
+        d.waiting = true;
+        CPU::int_enable();
+        d.done->p();
+    } else
+        CPU::int_enable();
+}
+
+SPI::DMA & SPI::open()
+{
+    DMA & d = _dma[_unit];
+
+    if(!_devices[_unit]) {
+        db<SPI>(TRC) << "SPI::open(unit=" << _unit << ")" << endl;
+
+        d.buffer = new (SYSTEM) MMU::DMA_Buffer(2 * DMA_TASKS * sizeof(DMA_Task) + sizeof(Reg32));
+        d.rx = static_cast<DMA_Task *>(d.buffer->log_address());
+        d.tx = d.rx + DMA_TASKS;
+        d.dummy = reinterpret_cast<Reg32 *>(d.tx + DMA_TASKS);
+        *d.dummy = 0;
+        d.done = new (SYSTEM) Semaphore(0);
+
+        // The handler needs an engine that outlives this object
+        _devices[_unit] = new (SYSTEM) SPI(*this);
+
+        IC::Interrupt_Id id = dma_interrupt();
+        IC::disable(id);
+        IC::int_vector(id, int_handler);
+        IC::eoi_vector(id, eoi);
+        IC::enable(id);
+    }
+
+    return d;
+}
+
+// Runs before interrupts are re-enabled, so the (level-triggered) done request is acknowledged before the handler
+void SPI::eoi(IC::Interrupt_Id id)
+{
+    unsigned int unit = int2unit(id);
+    DMA & d = _dma[unit];
+
+    if(d.busy && _devices[unit]->dma_done())
+        d.busy = false;
+}
+
+void SPI::int_handler(IC::Interrupt_Id id)
+{
+    unsigned int unit = int2unit(id);
+    DMA & d = _dma[unit];
+
+    CPU::int_disable();
+    if(d.busy && _devices[unit]->dma_done()) // on ICs that do not call eoi() before dispatching
+        d.busy = false;
+    Callback * callback = 0;
+    void * data = d.data;
+    bool waiting = false;
+    if(!d.busy) {
+        callback = d.callback;
+        d.callback = 0;
+        waiting = d.waiting;
+        d.waiting = false;
+    }
+    CPU::int_enable();
+
+    if(callback)
+        callback(data);
+    if(waiting)
+        d.done->v();
+}
+
+unsigned int SPI::int2unit(IC::Interrupt_Id id)
+{
+    for(unsigned int i = 0; i < UNITS; i++)
+        if(_devices[i] && (_devices[i]->dma_interrupt() == id))
+            return i;
+    return 0;
+}
+
+__END_SYS
+
+#endif
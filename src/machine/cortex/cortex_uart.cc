@@ -0,0 +1,182 @@
+// EPOS ARM Cortex UART Mediator Implementation
+
+#include <system.h>
+#include <machine/ic.h>
+#include <machine/uart.h>
+#include <synchronizer.h>
+
+#ifdef __UART_H
+
+__BEGIN_SYS
+
+// Class attributes
+UART * UART::_devices[UNITS];
+UART::Buffers UART::_buffers[UNITS];
+
+// Methods
+int UART::read(char * data, unsigned int size)
+{
+    unsigned int n = 0;
+    while(n < size) {
+        n += try_read(&data[n], size - n);
+        if(n < size)
+            wait_rx();
+    }
+    return n;
+}
+
+int UART::write(const char * data, unsigned int size)
+{
+    unsigned int n = 0;
+    while(n < size) {
+        n += try_write(&data[n], size - n);
+        if(n < size)
+            wait_tx();
+    }
+    return n;
+}
+
+int UART::try_read(char * data, unsigned int size)
+{
+    Buffers & b = open();
+
+    CPU::int_disable();
+    unsigned int n = 0;
+    for(; (n < size) && (b.rx_head != b.rx_tail); n++)
+        data[n] = b.rx[b.rx_head++ % BUFFER_SIZE];
+    CPU::int_enable();
+
+    return n;
+}
+
+int UART::try_write(const char * data, unsigned int size)
+{
+    Buffers & b = open();
+
+    CPU::int_disable();
+    unsigned int n = 0;
+    for(; (n < size) && (b.tx_tail - b.tx_head < BUFFER_SIZE); n++)
+        b.tx[b.tx_tail++ % BUFFER_SIZE] = data[n];
+    if(n) {
+        // Fill the FIFO right away; the transmit interrupt takes over from there
+        service(_unit);
+        if(b.tx_head != b.tx_tail)
+            int_enable(false, true, false, false);
+    }
+    CPU::int_enable();
+
+    return n;
+}
+
+void UART::flush()
+{
+    if(_devices[_unit]) {
+        Buffers & b = _buffers[_unit];
+        while(b.tx_head != b.tx_tail)
+            Thread::yield();
+    }
+    while(!txd_empty());
+}
+
+void UART::wait_rx()
+{
+    Buffers & b = _buffers[_unit];
+
+    CPU::int_disable();
+    if(b.rx_head == b.rx_tail) {
+        b.rx_waiting = true;
+        CPU::int_enable();
+        b.rx_ready->p();
+    } else
+        CPU::int_enable();
+}
+
+void UART::wait_tx()
+{
+    Buffers & b = _buffers[_unit];
+
+    CPU::int_disable();
+    if(b.tx_tail - b.tx_head == BUFFER_SIZE) {
+        b.tx_waiting = true;
+        CPU::int_enable();
+        b.tx_ready->p();
+    } else
+        CPU::int_enable();
+}
+
+UART::Buffers & UART::open()
+{
+    Buffers & b = _buffers[_unit];
+
+    if(!_devices[_unit]) {
+        db<UART>(TRC) << "UART::open(unit=" << _unit << ")" << endl;
+
+        b.rx_ready = new (SYSTEM) Semaphore(0);
+        b.tx_ready = new (SYSTEM) Semaphore(0);
+
+        // The handlers need an engine that outlives this object
+        _devices[_unit] = new (SYSTEM) UART(*this);
+
+        IC::Interrupt_Id id = unit2int(_unit);
+        IC::disable(id);
+        IC::int_vector(id, int_handler);
+        IC::eoi_vector(id, eoi);
+        int_disable(false, true, false, false);
+        int_enable(true, false, false, false);
+        IC::enable(id);
+    }
+
+    return b;
+}
+
+// Moves data between the ring buffers and the FIFOs; called with interrupts disabled
+void UART::service(unsigned int unit)
+{
+    UART * uart = _devices[unit];
+    Buffers & b = _buffers[unit];
+
+    while(uart->rxd_ok()) {
+        char c = uart->rxd();
+        if(b.rx_tail - b.rx_head < BUFFER_SIZE)
+            b.rx[b.rx_tail++ % BUFFER_SIZE] = c;
+        else
+            b.overruns++;
+    }
+
+    while((b.tx_head != b.tx_tail) && uart->txd_ok())
+        uart->txd(b.tx[b.tx_head++ % BUFFER_SIZE]);
+
+    if(b.tx_head == b.tx_tail)
+        uart->int_disable(false, true, false, false);
+}
+
+// Runs before interrupts are re-enabled, so the (level-triggered) request is cleared before the handler is called
+void UART::eoi(IC::Interrupt_Id id)
+{
+    service(int2unit(id));
+}
+
+void UART::int_handler(IC::Interrupt_Id id)
+{
+    unsigned int unit = int2unit(id);
+    Buffers & b = _buffers[unit];
+
+    CPU::int_disable();
+    service(unit); // on ICs that do not call eoi() before dispatching
+    bool rx = b.rx_waiting && (b.rx_head != b.rx_tail);
+    if(rx)
+        b.rx_waiting = false;
+    bool tx = b.tx_waiting && (b.tx_tail - b.tx_head < BUFFER_SIZE);
+    if(tx)
+        b.tx_waiting = false;
+    CPU::int_enable();
+
+    if(rx)
+        b.rx_ready->v();
+    if(tx)
+        b.tx_ready->v();
+}
+
+__END_SYS
+
+#endif
@@ -1,18 +1,179 @@
 // EPOS Cortex USB Mediator Implementation
 
+#include <system.h>
 #include <machine/ic.h>
 #include <machine/usb.h>
+#include <synchronizer.h>
 
 #ifdef __USB_H
 
 __BEGIN_SYS
 
+// Class attributes
+USB * USB::_device;
+USB::Rings USB::_rings;
+
+// Methods
+USB::Buffer * USB::receive()
+{
+    Buffer * buf;
+    while(!(buf = try_receive())) {
+        CPU::int_disable();
+        if(_rings.rx_next == _rings.rx_tail) {
+            _rings.rx_waiting = true;
+            CPU::int_enable();
+            _rings.rx_ready->p();
+        } else
+            CPU::int_enable();
+    }
+    return buf;
+}
+
+USB::Buffer * USB::try_receive()
+{
+    Rings & r = open();
+
+    CPU::int_disable();
+    Buffer * buf = 0;
+    if(r.rx_next != r.rx_tail)
+        buf = r.rx[r.rx_next++ % BUFFERS];
+    CPU::int_enable();
+
+    return buf;
+}
+
+void USB::release(Buffer * buf)
+{
+    Rings & r = _rings;
+
+    CPU::int_disable();
+    assert((r.rx_head != r.rx_next) && (buf == r.rx[r.rx_head % BUFFERS]));
+    r.rx_head++;
+    service(); // a packet may be held in the FIFO for lack of buffers
+    CPU::int_enable();
+}
+
+USB::Buffer * USB::alloc()
+{
+    Buffer * buf;
+    while(!(buf = try_alloc())) {
+        CPU::int_disable();
+        if(_rings.tx_next - _rings.tx_head == BUFFERS) {
+            _rings.tx_waiting = true;
+            CPU::int_enable();
+            _rings.tx_ready->p();
+        } else
+            CPU::int_enable();
+    }
+    return buf;
+}
+
+USB::Buffer * USB::try_alloc()
+{
+    Rings & r = open();
+
+    CPU::int_disable();
+    Buffer * buf = 0;
+    if(r.tx_next - r.tx_head < BUFFERS) {
+        buf = r.tx[r.tx_next++ % BUFFERS];
+        buf->size(PACKET_SIZE);
+    }
+    CPU::int_enable();
+
+    return buf;
+}
+
+void USB::send(Buffer * buf)
+{
+    Rings & r = _rings;
+
+    assert(buf->size() <= PACKET_SIZE);
+
+    CPU::int_disable();
+    assert((r.tx_tail != r.tx_next) && (buf == r.tx[r.tx_tail % BUFFERS]));
+    r.tx_tail++;
+    service(); // load the FIFO right away; the IN interrupt takes over from there
+    CPU::int_enable();
+}
+
+USB::Rings & USB::open()
+{
+    Rings & r = _rings;
+
+    if(!_device) {
+        db<USB>(TRC) << "USB::open()" << endl;
+
+        USB * device = new (SYSTEM) USB;
+        for(unsigned int i = 0; i < BUFFERS; i++) {
+            r.rx[i] = new (SYSTEM) Buffer(device, 0);
+            r.tx[i] = new (SYSTEM) Buffer(device, 0);
+        }
+        r.rx_ready = new (SYSTEM) Semaphore(0);
+        r.tx_ready = new (SYSTEM) Semaphore(0);
+
+        // The handlers start servicing the rings as soon as _device is set
+        CPU::int_disable();
+        _device = device;
+        _device->packet_int_enable();
+        service(); // packets may have arrived before the interrupts were enabled
+        CPU::int_enable();
+    }
+
+    return r;
+}
+
+// Moves whole packets between the buffer rings and the endpoint FIFOs; called with interrupts disabled
+void USB::service()
+{
+    if(!_device)
+        return;
+
+    USB * usb = _device;
+    Rings & r = _rings;
+
+    int index = usb->endpoint(); // the interrupted code may be in the middle of an endpoint access
+
+    // When the ring is full, the packet stays in the FIFO and the controller NAKs the host until a buffer is released
+    while((r.rx_tail - r.rx_head < BUFFERS) && usb->rx_packet_ok()) {
+        Buffer * buf = r.rx[r.rx_tail % BUFFERS];
+        buf->size(usb->rx_packet(buf->data()->payload));
+        r.rx_tail++;
+    }
+
+    while((r.tx_head != r.tx_tail) && usb->tx_packet_ok()) {
+        Buffer * buf = r.tx[r.tx_head % BUFFERS];
+        usb->tx_packet(buf->data()->payload, buf->size());
+        r.tx_head++;
+    }
+
+    usb->endpoint(index);
+}
+
 void USB::int_handler(IC::Interrupt_Id i) {
     Engine usb; usb.handle_int(i);
+
+    Rings & r = _rings;
+
+    CPU::int_disable();
+    service(); // on ICs that do not call eoi() before dispatching and after the host opens the port (in handle_int)
+    bool rx = r.rx_waiting && (r.rx_next != r.rx_tail);
+    if(rx)
+        r.rx_waiting = false;
+    bool tx = r.tx_waiting && (r.tx_next - r.tx_head < BUFFERS);
+    if(tx)
+        r.tx_waiting = false;
+    CPU::int_enable();
+
+    if(rx)
+        r.rx_ready->v();
+    if(tx)
+        r.tx_ready->v();
 }
 
+// Runs before interrupts are re-enabled, so endpoint FIFOs are serviced as soon as the controller raises the request
 void USB::eoi(IC::Interrupt_Id int_id) {
     Engine usb; usb.eoi();
+    service();
 }
 
 __END_SYS
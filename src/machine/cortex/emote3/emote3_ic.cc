@@ -2,6 +2,7 @@
 
 #include <machine/machine.h>
 #include <machine/ic.h>
+#include <tracer.h>
 
 extern "C" { void _int_entry() __attribute__ ((alias("_ZN4EPOS1S2IC5entryEv"))); }
 extern "C" { void _dispatch(unsigned int) __attribute__ ((alias("_ZN4EPOS1S2IC8dispatchEj"))); }
@@ -140,10 +141,14 @@ void IC::entry()
 
 void IC::dispatch(unsigned int id)
 {
+    CPU::int_off_discard();
+
     if((id != INT_SYS_TIMER) || Traits<IC>::hysterically_debugged)
         db<IC>(TRC) << "IC::dispatch(i=" << id << ")" << endl;
 
+    Tracer::trace<IC>(Tracer::IRQ_ENTRY, id);
     _int_vector[id](id);
+    Tracer::trace<IC>(Tracer::IRQ_EXIT, id);
 }
 
 void IC::eoi(unsigned int id)
@@ -0,0 +1,16 @@
+// EPOS eMote3 (ARM Cortex-M3) SPI Mediator Implementation
+
+#include <system/config.h>
+
+#ifdef __SPI_H
+
+#include <machine/spi.h>
+
+__BEGIN_SYS
+
+// Class attributes
+SPI_Engine::DMA_Task SPI_Engine::_dma_table[] __attribute__((aligned(1024)));
+
+__END_SYS
+
+#endif
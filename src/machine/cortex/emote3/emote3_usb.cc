@@ -16,6 +16,7 @@ volatile USB_2_0::STATE USB_Engine::_state;
 volatile bool USB_Engine::_ready_to_put = false;
 volatile bool USB_Engine::_ready_to_put_next = false;
 volatile bool USB_Engine::_locked = false;
+volatile bool USB_Engine::_packet_ints = false;
 
 char USB_Engine::get()
 {
@@ -79,7 +80,7 @@ int USB_Engine::write(const char * c, unsigned int size)
     lock();
     output();
     while(usb(CS0_CSIL) & CSIL_INPKTRDY);
-    for(unsigned int i = 0; (i < _max_packet_ep3) and (i < size); i++)
+    for(unsigned int i = 0; (i < PACKET_SIZE) and (i < size); i++)
         usb(F3) = c[i];
     flush();
     unlock();
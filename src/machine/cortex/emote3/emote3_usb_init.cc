@@ -109,7 +109,7 @@ const USB_Engine::Full_Config USB_Engine::_config =
         DESC_ENDPOINT,               // Descriptor type (DESC_ENDPOINT)
         3 | (1 << 7),                // Encoded Address: Endpoint 3, IN
         EP_ATTR_BULK,                // Endpoint attributes (Bulk endpoint)
-        32,                          // Maximum packet size this endpoint is capable of sending or receiving at once
+        PACKET_SIZE,                 // Maximum packet size this endpoint is capable of sending or receiving at once
         0x00                         // Interval (ignored for Bulk operation)
     },
     //_endpoint2_descriptor =
@@ -118,7 +118,7 @@ const USB_Engine::Full_Config USB_Engine::_config =
         DESC_ENDPOINT,               // Descriptor type (DESC_ENDPOINT)
         4,                           // Encoded address: Endpoint 4, OUT
         EP_ATTR_BULK,                // Endpoint attributes (Bulk endpoint)
-        _max_packet_ep4,             // Maximum packet size this endpoint is capable of sending or receiving at once
+        PACKET_SIZE,                 // Maximum packet size this endpoint is capable of sending or receiving at once
         0x00                         // Interval (ignored for Bulk operation)
     }
 };
@@ -134,9 +134,11 @@ void USB_Engine::reset()
 
     // Set up endpoints
     output();
-    // The two lines below make the USB automatically signal that a packet is ready every 32 characters.
-    usb(MAXI) = 32 / 8; // Endpoint 3, IN.
+    // The two lines below make the USB automatically signal that a packet is ready every PACKET_SIZE characters.
+    usb(MAXI) = PACKET_SIZE / 8; // Endpoint 3, IN.
     usb(MAXO) = 0;
+    // Endpoint 3's FIFO (128 bytes) holds two packets, so one can be loaded while the other is on the bus
+    usb(CSIH) |= INDBLBUF;
     usb(CS0_CSIL) |= CSIL_CLRDATATOG; // From cc2538 User Guide: When a Bulk IN endpoint is first configured, USB_CSIL.CLRDATATOG should be set.
     // if there are any data packets in the FIFO, they should be flushed. It may be necessary to set this bit twice in succession if double buffering is enabled.
     usb(CS0_CSIL) |= CSIL_FLUSHPACKET;
@@ -144,15 +146,18 @@ void USB_Engine::reset()
 
     input();
     usb(MAXI) = 0;
-    usb(MAXO) = _max_packet_ep4 / 8; // Endpoint 4, OUT
+    usb(MAXO) = PACKET_SIZE / 8; // Endpoint 4, OUT
+    // Endpoint 4's FIFO (256 bytes) holds two packets, so the host can send one while the other is unloaded
+    usb(CSOH) |= OUTDBLBUF;
     usb(CSOL) |= CSOL_CLRDATATOG; // From cc2538 User Guide: When a Bulk OUT endpoint is first configured, USB_CSOL.CLRDATATOG should be set.
     // if there are any data packets in the FIFO, they should be flushed
     usb(CSOL) |= CSOL_FLUSHPACKET;
+    usb(CSOL) |= CSOL_FLUSHPACKET;
 
-    // Only enable IN interrupts for endpoints 0 and 2
-    usb(IIE) = (1 << 0);// | (1 << 2);
-    // Only enable OUT interrupts for endpoint 0
-    usb(OIE) = (1 << 0);
+    // Enable IN interrupts for endpoint 0 and, in packet mode, for endpoint 3
+    usb(IIE) = (1 << 0) | (_packet_ints ? (1 << 3) : 0);
+    // Enable OUT interrupts for endpoint 0 and, in packet mode, for endpoint 4
+    usb(OIE) = (1 << 0) | (_packet_ints ? (1 << 4) : 0);
     // Only enable RESET common interrupt (disable start-of-frame, resume and suspend)
     usb(CIE) = INT_RESET;
 }
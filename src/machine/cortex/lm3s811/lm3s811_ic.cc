@@ -2,6 +2,7 @@
 
 #include <machine/machine.h>
 #include <machine/ic.h>
+#include <tracer.h>
 #include <machine/timer.h>
 #include <machine/usb.h>
 #include <machine/gpio.h>
@@ -204,10 +205,14 @@ void IC::entry()
 
 void IC::dispatch(unsigned int id)
 {
+    CPU::int_off_discard();
+
     if((id != INT_SYS_TIMER) || Traits<IC>::hysterically_debugged)
         db<IC>(TRC) << "IC::dispatch(i=" << id << ")" << endl;
 
+    Tracer::trace<IC>(Tracer::IRQ_ENTRY, id);
     _int_vector[id](id);
+    Tracer::trace<IC>(Tracer::IRQ_EXIT, id);
 }
 
 void IC::eoi(unsigned int id)
@@ -3,6 +3,8 @@
 #include <architecture/cpu.h>
 #include <machine/machine.h>
 #include <machine/ic.h>
+#include <tracer.h>
+#include <process.h>
 #include <machine/timer.h>
 #include <machine/usb.h>
 #include <machine/gpio.h>
@@ -10,6 +12,7 @@
 extern "C" { void _int_entry() __attribute__ ((alias("_ZN4EPOS1S2IC5entryEv"))); }
 extern "C" { void _dispatch(unsigned int) __attribute__ ((alias("_ZN4EPOS1S2IC8dispatchEj"))); }
 extern "C" { void _eoi(unsigned int) __attribute__ ((alias("_ZN4EPOS1S2IC3eoiEj"))); }
+extern "C" { void _handle(unsigned int) __attribute__ ((alias("_ZN4EPOS1S2IC6handleEj"))); }
 extern "C" { void _undefined_instruction() __attribute__ ((alias("_ZN4EPOS1S2IC21undefined_instructionEv"))); }
 extern "C" { void _software_interrupt() __attribute__ ((alias("_ZN4EPOS1S2IC18software_interruptEv"))); }
 extern "C" { void _prefetch_abort() __attribute__ ((alias("_ZN4EPOS1S2IC14prefetch_abortEv"))); }
@@ -36,6 +39,18 @@ __BEGIN_SYS
 
 // Class attributes
 IC::Interrupt_Handler IC::_int_vector[IC::INTS];
+
+// Per-CPU interrupt stacks (see Traits<IC>::irq_stack)
+static const unsigned int IRQ_STACKS = Traits<IC>::irq_stack ? Traits<Build>::CPUS : 1;
+static char irq_stack[IRQ_STACKS][Traits<IC>::IRQ_STACK_SIZE] __attribute__((aligned(8)));
+static volatile unsigned int irq_nesting[Traits<Build>::CPUS];
+
+// Software priorities (see IC_Engine::mask())
+IC_Engine::Priority IC_Engine::_priority[];
+CPU::Reg32 IC_Engine::_level[][IC_Engine::BANKS];
+volatile CPU::Reg32 IC_Engine::_enabled[];
+CPU::Reg32 IC_Engine::_masked[][IC_Engine::BANKS];
+
 // Class attributes
 IC::Interrupt_Handler IC::_eoi_vector[INTS] = {
     0,
@@ -184,6 +199,8 @@ void IC::entry()
         "str r0, [r2]                               \n"
         // Save IRQ-spsr
         "stmfd sp!, {r1}                            \n"
+        // Pass the PMU cycle counter at entry to dispatch (for IRQ_Profiler)
+        "mrc p15, 0, r0, c9, c13, 0                 \n"
         //"bl %0                                      \n"
         "bl _dispatch                               \n"
         "ldmfd sp!, {r0}                            \n"
@@ -194,7 +211,41 @@ void IC::entry()
         "ldmfd sp!, {r0-r3, r12, lr, pc}^           \n" : : "i"(dispatch));
 }
 
-void IC::dispatch(unsigned int i)
+void IC::dispatch(unsigned int entry)
+{
+    CPU::int_off_discard();
+
+    // The interrupted context has already been saved on the thread's stack by entry(). Only the outermost interrupt
+    // switches stacks, nested ones are already running on this CPU's interrupt stack. Rescheduling is deferred until
+    // the outermost handler returns, both to leave the interrupt stack and to drop the priority masks of handle().
+    unsigned int cpu = CPU::id();
+    if(irq_nesting[cpu]++)
+        handle(entry);
+    else {
+        Thread::int_enter();
+        if(Traits<IC>::irq_stack)
+            switch_stack(entry, &irq_stack[cpu][Traits<IC>::IRQ_STACK_SIZE]);
+        else
+            handle(entry);
+    }
+
+    CPU::int_disable();
+    if(!--irq_nesting[cpu])
+        Thread::int_leave(); // back on the thread's stack, where a deferred reschedule() can switch contexts
+}
+
+void IC::switch_stack(unsigned int entry, void * stack)
+{
+    ASM("mov r12, sp                                \n"
+        "mov sp, r1                                 \n"
+        "push {r12, lr}                             \n"
+        "bl _handle                                 \n"
+        "pop {r12, lr}                              \n"
+        "mov sp, r12                                \n"
+        "bx lr                                      \n");
+}
+
+void IC::handle(unsigned int entry)
 {
     Interrupt_Id id = int_id();
 
@@ -205,9 +256,24 @@ void IC::dispatch(unsigned int i)
     if(_eoi_vector[id])
         _eoi_vector[id](id);
 
+    // Only more urgent interrupts can preempt this handler
+    Reg32 masked[Engine::BANKS];
+    Engine::mask(Engine::priority(id), masked);
+
+    IRQ_Profiler::Cycles start = Traits<Tracer>::irq_profile ? PMU::cycles() : 0;
+
     CPU::int_enable();
 
+    Tracer::trace<IC>(Tracer::IRQ_ENTRY, id);
     _int_vector[id](id);
+    Tracer::trace<IC>(Tracer::IRQ_EXIT, id);
+
+    CPU::int_disable(); // the context restore in entry() reloads the interrupted CPSR anyway
+
+    if(Traits<Tracer>::irq_profile)
+        IRQ_Profiler::account(id, entry, start, PMU::cycles());
+
+    Engine::unmask(masked);
 }
 
 void IC::eoi(unsigned int id)
@@ -28,6 +28,9 @@ void IC::init()
     for(Interrupt_Id i = 0; i < INTS; i++)
         _int_vector[i] = int_not;
 
+    // Time-critical interrupts preempt the handlers of all others
+    priority(INT_SYS_TIMER, PRIORITY_HIGH);
+
     // As we are using virtual memory for system code, we need to update Vector table handler addresses
     if (Traits<System>::multitask) { 
         CPU::Reg32 * handler_entry = reinterpret_cast<CPU::Reg32 *>(0x20);
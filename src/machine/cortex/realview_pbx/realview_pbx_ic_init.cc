@@ -119,6 +119,10 @@ void IC::init()
     // Set all interrupt handlers to int_not()
     for(Interrupt_Id i = 0; i < INTS; i++)
         _int_vector[i] = int_not;
+
+    // Time-critical interrupts preempt the handlers of all others
+    priority(INT_SYS_TIMER, PRIORITY_HIGH);
+    priority(INT_NIC0_RX, PRIORITY_HIGH);
 }
 
 __END_SYS
@@ -2,6 +2,8 @@
 
 #include <machine/machine.h>
 #include <machine/ic.h>
+#include <tracer.h>
+#include <process.h>
 
 extern "C" { void _int_entry() __attribute__ ((alias("_ZN4EPOS1S2IC5entryEv"))); }
 extern "C" { void _dispatch(unsigned int) __attribute__ ((alias("_ZN4EPOS1S2IC8dispatchEj"))); }
@@ -18,6 +20,9 @@ __BEGIN_SYS
 // Class attributes
 IC::Interrupt_Handler IC::_int_vector[IC::INTS];
 
+// Per-CPU interrupt nesting depth
+static volatile unsigned int irq_nesting[Traits<Build>::CPUS];
+
 
 // Class methods
 void IC::entry()
@@ -57,6 +62,8 @@ void IC::entry()
 
 void IC::dispatch(unsigned int i)
 {
+    CPU::int_off_discard();
+
     Interrupt_Id id = int_id();
 
     if((id != INT_SYS_TIMER) || Traits<IC>::hysterically_debugged)
@@ -66,9 +73,24 @@ void IC::dispatch(unsigned int i)
     if(_eoi_vector[id])
         _eoi_vector[id](id);
 
+    // Raise the GIC priority mask to this interrupt's priority, so only more urgent interrupts can preempt its handler.
+    // Rescheduling is deferred until the outermost handler returns, otherwise the next thread would inherit the mask.
+    unsigned int cpu = CPU::id();
+    Priority mask = Engine::mask();
+    Engine::mask(Engine::priority(id));
+    if(!irq_nesting[cpu]++)
+        Thread::int_enter();
+
     CPU::int_enable();
 
+    Tracer::trace<IC>(Tracer::IRQ_ENTRY, id);
     _int_vector[id](id);
+    Tracer::trace<IC>(Tracer::IRQ_EXIT, id);
+
+    CPU::int_disable(); // the context restore in entry() reloads the interrupted CPSR anyway
+    Engine::mask(mask);
+    if(!--irq_nesting[cpu])
+        Thread::int_leave();
 }
 
 void IC::eoi(unsigned int id)
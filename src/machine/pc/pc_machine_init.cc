@@ -1,6 +1,7 @@
 // EPOS PC Mediator Initialization
 
 #include <machine.h>
+#include <tracer.h>
 
 __BEGIN_SYS
 
@@ -25,9 +26,11 @@ void Machine::init()
     if(Traits<IC>::enabled)
         IC::init();
 
+    Boot_Tracer::stamp(Boot_Trace::TIMER_INIT);
     if(Traits<Timer>::enabled)
         Timer::init();
 
+    Boot_Tracer::stamp(Boot_Trace::DEVICES_INIT);
     if(Traits<PCI>::enabled)
         PCI::init();
 
@@ -1,6 +1,7 @@
 // EPOS RISC V Initialization
 
 #include <machine.h>
+#include <tracer.h>
 
 __BEGIN_SYS
 
@@ -38,6 +39,7 @@ void Machine::init()
     if(Traits<IC>::enabled)
         IC::init();
 
+    Boot_Tracer::stamp(Boot_Trace::TIMER_INIT);
     if(Traits<Timer>::enabled)
         Timer::init();
 }
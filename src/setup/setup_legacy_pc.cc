@@ -117,6 +117,7 @@ Setup::Setup(char * boot_image)
     bi = reinterpret_cast<char *>(boot_image);
 
     si = reinterpret_cast<System_Info *>(bi);
+    si->bt.reset(); // this SETUP does not stamp its phases, INIT does
 
     Display::init();
     VGA::init(VGA_PHY); // Display can be Serial_Display, so VGA here!
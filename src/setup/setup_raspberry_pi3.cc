@@ -76,11 +76,16 @@ public:
 
 private:
     void flat_map_page_tables_setup();
+    void start_aps();
     void build_lm();
     void build_pmm();
+    Phy_Addr segment(Phy_Addr top_page, unsigned int size);
 
     void say_hi();
 
+    void clear_frames();
+    void clear(unsigned int base, unsigned int size);
+
     void configure_page_table_descriptors(PT_Entry * pts, Phy_Addr base, unsigned int size, unsigned int n_pts, Flags flag, bool print = false);
     void setup_sys_pt();
     void setup_app_pt();
@@ -92,13 +97,25 @@ private:
 
     void panic() { Machine::panic(); }
 
+    // Boot trace stamps come from the BCM2835 system timer (i.e. the TSC), which is reached through its physical
+    // address until paging is enabled
+    void stamp(Boot_Trace::Phase phase) {
+        if(Traits<Tracer>::boot_trace)
+            si->bt.stamp(phase, reinterpret_cast<volatile Reg32 *>(tsc)[1]); // STCLO
+    }
+
 private:
     char * bi;
     System_Info * si;
+    unsigned int tsc;
 
+    static volatile bool pmm_ready;
+    static volatile bool cleared[Traits<Machine>::CPUS];
     static volatile bool paging_ready;
 };
 
+volatile bool Setup::pmm_ready = false;
+volatile bool Setup::cleared[Traits<Machine>::CPUS];
 volatile bool Setup::paging_ready = false;
 Setup::Setup()
 {
@@ -107,6 +124,11 @@ Setup::Setup()
     if(Traits<System>::multitask) {
         bi = reinterpret_cast<char *>(IMAGE);
         si = reinterpret_cast<System_Info *>(&__boot_time_system_info);
+        tsc = Memory_Map::TSC_BASE - MIO_OFFSET;
+        if(CPU::id() == 0) {
+            si->bt.reset();
+            stamp(Boot_Trace::SETUP);
+        }
 
         db<Setup>(TRC) << "Setup(bi=" << reinterpret_cast<void *>(bi) << ",sp=" << reinterpret_cast<void *>(CPU::sp()) << ")" << endl;
         db<Setup>(INF) << "Setup:si=" << *si << endl;
@@ -115,22 +137,32 @@ Setup::Setup()
             si->bm.n_cpus = Traits<Machine>::CPUS;
 
         if(CPU::id() == 0) { // Boot strap CPU (BSP)
+            // Release the APs right away, so they can help clearing memory
+            start_aps();
+
             // Build the memory model
+            stamp(Boot_Trace::BUILD_LM);
             build_lm();
+            stamp(Boot_Trace::BUILD_PMM);
             build_pmm();
 
             // Print basic facts about this EPOS instance
             say_hi();
 
             // Configure the memory model defined above
+            stamp(Boot_Trace::PAGE_TABLES);
+            clear_frames();
             setup_sys_pt();
             setup_app_pt();
             setup_sys_pd();
 
             // Enable paging
+            stamp(Boot_Trace::PAGING);
             enable_paging();
+            tsc = Memory_Map::TSC_BASE;
 
             // Load EPOS parts (e.g. INIT, SYSTEM, APPLICATION)
+            stamp(Boot_Trace::LOAD_PARTS);
             load_parts();
 
             // Signalize other CPUs that paging is up
@@ -138,6 +170,10 @@ Setup::Setup()
 
         } else { // Additional CPUs (APs)
 
+            // Wait for the Boot CPU to reserve memory and help clearing it
+            while(!pmm_ready);
+            clear_frames();
+
             // Wait for the Boot CPU to setup page tables
             while(!paging_ready);
 
@@ -182,6 +218,15 @@ void Setup::flat_map_page_tables_setup()
     }
 }
 
+void Setup::start_aps()
+{
+    db<Setup>(TRC) << "Setup::start_aps(n=" << si->bm.n_cpus << ")" << endl;
+
+    BCM_Mailbox * mbox = reinterpret_cast<BCM_Mailbox *>(Memory_Map::MBOX_CTRL_BASE);
+    for(unsigned int i = 1; i < si->bm.n_cpus; i++)
+        mbox->start(i, reinterpret_cast<Reg32>(&_reset));
+}
+
 void Setup::build_lm()
 {
     db<Setup>(TRC) << "Setup::build_lm()" << endl;
@@ -389,20 +434,10 @@ void Setup::build_pmm()
     top_page -= 1;
     si->pmm.sys_pt = top_page * sizeof(Page);
 
-    // Page tables to map the whole physical memory
-    // = NP/NPTE_PT * sizeof(Page)
-    //   NP = size of physical memory in pages
-    //   NPTE_PT = number of page table entries per page table, e.g., 256 in this config (12, 8, 12)
-    db<Setup>(INF) << "Setup::build_pmm(): mmu::pages for phy_mem_pts;" << MMU::page_tables(MMU::pages(si->bm.mem_top - si->bm.mem_base)) << ", and curr top_page=" << top_page << endl;
-    top_page -= MMU::page_tables(MMU::pages(si->bm.mem_top - si->bm.mem_base));
-    si->pmm.phy_mem_pts = top_page * sizeof(Page);
-
-    // Page tables to map the IO address space
-    // = NP/NPTE_PT * sizeof(Page)
-    // NP = size of I/O address space in pages
-    // NPTE_PT = number of page table entries per page table
-    top_page -= MMU::page_tables(MMU::pages(si->bm.mio_top - si->bm.mio_base));
-    si->pmm.io_pts = top_page * sizeof(Page);
+    // The whole physical memory and the IO address space are mapped with 1 MB sections straight from the directory,
+    // so they need no page tables
+    si->pmm.phy_mem_pts = 0;
+    si->pmm.io_pts = 0;
 
     // Page tables to map the first APPLICATION code segment
     top_page -= MMU::page_tables(MMU::pages(si->lm.app_code_size));
@@ -418,11 +453,11 @@ void Setup::build_pmm()
     si->pmm.sys_info = top_page * sizeof(Page);
 
     // SYSTEM code segment -- For this test, everything will be in physical memory 
-    top_page -= MMU::pages(si->lm.sys_code_size);
+    top_page = segment(top_page, si->lm.sys_code_size);
     si->pmm.sys_code = top_page * sizeof(Page);
 
     // SYSTEM data segment
-    top_page -= MMU::pages(si->lm.sys_data_size);
+    top_page = segment(top_page, si->lm.sys_data_size);
     si->pmm.sys_data = top_page * sizeof(Page);
 
     // The memory allocated so far will "disappear" from the system as we set mem_top as follows:
@@ -430,12 +465,20 @@ void Setup::build_pmm()
     si->pmm.usr_mem_top = top_page * sizeof(Page);
 
     // APPLICATION code segment
-    top_page -= MMU::pages(si->lm.app_code_size);
+    top_page = segment(top_page, si->lm.app_code_size);
     si->pmm.app_code = top_page * sizeof(Page);
 
     // APPLICATION data segment (contains stack, heap and extra)
-    top_page -= MMU::pages(si->lm.app_data_size);
+    // MKBI lays extras out in page-aligned records, so they are mapped in place from the boot image instead of
+    // getting frames of their own (and being copied)
+    unsigned int extras = reinterpret_cast<unsigned int>(&bi[si->bm.extras_offset]);
+    unsigned int extra_size = 0;
+    if(si->lm.has_ext && !MMU::offset(extras) && !MMU::offset(si->lm.app_extra_size)
+       && (extras >= si->lm.stp_code + si->lm.stp_code_size + si->lm.stp_data_size))
+        extra_size = si->lm.app_extra_size;
+    top_page = segment(top_page, si->lm.app_data_size - extra_size);
     si->pmm.app_data = top_page * sizeof(Page);
+    si->pmm.app_extra = extra_size ? extras : si->pmm.app_data + si->lm.app_data_size - si->lm.app_extra_size;
 
     // SYSTEM stack segment -- We use boot stack right after sys_pt
     top_page -= MMU::pages(si->lm.sys_stack_size);
@@ -444,6 +487,13 @@ void Setup::build_pmm()
     // Free chunks (passed to MMU::init)
     si->pmm.free1_base = si->lm.stp_code + si->lm.stp_code_size + si->lm.stp_data_size; // vector table should not be deleted!
     si->pmm.free1_top = top_page * sizeof(Page); // we will free the stack here
+    si->pmm.free2_base = 0;
+    si->pmm.free2_top = 0;
+    if(extra_size) { // extras mapped in place split the free memory in two
+        si->pmm.free2_base = si->pmm.app_extra + extra_size;
+        si->pmm.free2_top = si->pmm.free1_top;
+        si->pmm.free1_top = si->pmm.app_extra;
+    }
     db<Setup>(TRC) << "Top page = " << top_page << endl;
 
     // Test if we didn't overlap SETUP and the boot image
@@ -451,6 +501,22 @@ void Setup::build_pmm()
         db<Setup>(ERR) << "SETUP would have been overwritten!" << endl;
         panic();
     }
+
+    // Test if we didn't overlap the extras in the boot image either
+    if(extra_size && (si->pmm.free2_base > si->pmm.free2_top)) {
+        db<Setup>(ERR) << "EXTRA would have been overwritten!" << endl;
+        panic();
+    }
+}
+
+// Allocates the frames of a segment right below top_page; segments spanning large pages get 64 KB aligned frames, so
+// configure_page_table_descriptors() can map them with large pages wherever their logical addresses are aligned too
+Setup::Phy_Addr Setup::segment(Phy_Addr top_page, unsigned int size)
+{
+    top_page -= MMU::pages(size);
+    if(MMU::pages(size) >= MMU::LARGE_PAGES)
+        top_page -= top_page % MMU::LARGE_PAGES;
+    return top_page;
 }
 
 void Setup::say_hi()
@@ -496,13 +562,64 @@ void Setup::say_hi()
     kout << endl;
 }
 
+void Setup::clear_frames()
+{
+    db<Setup>(TRC) << "Setup::clear_frames(cpu=" << CPU::id() << ")" << endl;
+
+    if(CPU::id() == 0) {
+        for(unsigned int i = 1; i < si->bm.n_cpus; i++)
+            cleared[i] = false;
+        pmm_ready = true;
+    }
+
+    // Page tables and the System Page Directory, which build_pmm() reserved contiguously from app_data_pts up
+    clear(si->pmm.app_data_pts, si->pmm.sys_pd + sizeof(Page_Directory) - si->pmm.app_data_pts);
+
+    // Data segments (i.e. BSS and the application's stack and heap), so load_parts() doesn't have to zero BSS
+    // serially (extras are either copied over or mapped in place and are left alone)
+    if(si->bm.n_cpus > 1) {
+        clear(si->pmm.sys_data, MMU::pages(si->lm.sys_data_size) * sizeof(Page));
+        clear(si->pmm.app_data, MMU::pages(si->lm.app_data_size - si->lm.app_extra_size) * sizeof(Page));
+    }
+
+    // The MMU is still off, so these flags are strongly ordered and a join is all the barrier we need
+    if(CPU::id() == 0) {
+        for(unsigned int i = 1; i < si->bm.n_cpus; i++)
+            while(!cleared[i]);
+    } else if(CPU::id() < si->bm.n_cpus)
+        cleared[CPU::id()] = true;
+}
+
+// Each CPU zeroes an equal, page-aligned slice of [base, base + size), with the last one also taking the remainder
+void Setup::clear(unsigned int base, unsigned int size)
+{
+    unsigned int n = si->bm.n_cpus;
+    unsigned int cpu = CPU::id();
+    if(cpu >= n)
+        return;
+
+    unsigned int slice = MMU::pages(size) / n * sizeof(Page);
+    unsigned int from = cpu * slice;
+    unsigned int to = (cpu == n - 1) ? size : from + slice;
+    memset(reinterpret_cast<void *>(base + from), 0, to - from);
+}
+
 void Setup::configure_page_table_descriptors(PT_Entry * pts, Phy_Addr base, unsigned int size, unsigned int n_pts, Flags flag, bool print) {
     // n_pts equal to the number of PDs necessary to map the requested PTEs (given by size) from the memory base 
     // Each PTE maps one Page (4k), 
     // Each Page can have 4 pages with 256 ptes each
     // Thus, for each PD, map 256 pte until all requested ptes are mapped
+    // Runs of 16 entries that start on a 64-byte boundary (i.e. a 64 KB aligned logical address) and map a 64 KB
+    // aligned frame become a large page
     for (unsigned int i = 0; i < size; i++) {
-        pts[i] = MMU::phy2pte((base + i * sizeof(Page)), flag);
+        Phy_Addr frame = base + i * sizeof(Page);
+        if(!(reinterpret_cast<unsigned int>(&pts[i]) & (MMU::LARGE_PAGES * sizeof(PT_Entry) - 1)) && !(frame & (MMU::LARGE_PAGE_SIZE - 1)) && (size - i >= MMU::LARGE_PAGES)) {
+            PT_Entry lpte = MMU::phy2lpte(frame, flag);
+            for(unsigned int j = 0; j < MMU::LARGE_PAGES; j++)
+                pts[i + j] = lpte;
+            i += MMU::LARGE_PAGES - 1;
+        } else
+            pts[i] = MMU::phy2pte(frame, flag);
         if (Traits<Setup>::hysterically_debugged && print)
             db<Setup>(INF) << "pts[" << i << "]=" << pts[i] << ",addr="<< &pts[i] << endl;
     }
@@ -522,8 +639,7 @@ void Setup::setup_sys_pt()
     // Get the physical address for the SYSTEM Page Table
     PT_Entry * sys_pt = reinterpret_cast<PT_Entry *>(si->pmm.sys_pt);
 
-    // Clear the System Page Table
-    memset(sys_pt, 0, sizeof(Page));
+    // The System Page Table was cleared by clear_frames()
 
     // System Info
     sys_pt[MMU::directory(SYS_INFO - SYS) * (MMU::PT_ENTRIES) + MMU::page(SYS_INFO)] = MMU::phy2pte(si->pmm.sys_info, Flags::SYS);
@@ -565,15 +681,15 @@ void Setup::setup_app_pt()
     PT_Entry * app_code_pt = reinterpret_cast<PT_Entry *>(si->pmm.app_code_pts);
     PT_Entry * app_data_pt = reinterpret_cast<PT_Entry *>(si->pmm.app_data_pts);
 
-    // Clear the first APPLICATION Page Tables
-    memset(app_code_pt, 0, MMU::page_tables(MMU::pages(si->lm.app_code_size)) * sizeof(Page_Table));
-    memset(app_data_pt, 0, MMU::page_tables(MMU::pages(si->lm.app_data_size)) * sizeof(Page_Table));
+    // The first APPLICATION Page Tables were cleared by clear_frames()
 
     // APPLICATION code
     configure_page_table_descriptors(reinterpret_cast<PT_Entry *>(&app_code_pt[MMU::page(si->lm.app_code)]), si->pmm.app_code, MMU::pages(si->lm.app_code_size), MMU::page_tables(MMU::pages(si->lm.app_code_size)), Flags::APP);
 
-    // APPLICATION data (contains stack, heap and extra)
-    configure_page_table_descriptors(reinterpret_cast<PT_Entry *>(&app_data_pt[MMU::page(si->lm.app_data)]), si->pmm.app_data, MMU::pages(si->lm.app_data_size), MMU::page_tables(MMU::pages(si->lm.app_data_size)), Flags::APP);
+    // APPLICATION data (contains stack, heap and extra, whose frames might be in the boot image)
+    unsigned int data_pages = MMU::pages(si->lm.app_data_size - si->lm.app_extra_size);
+    configure_page_table_descriptors(reinterpret_cast<PT_Entry *>(&app_data_pt[MMU::page(si->lm.app_data)]), si->pmm.app_data, data_pages, MMU::page_tables(data_pages), Flags::APP);
+    configure_page_table_descriptors(reinterpret_cast<PT_Entry *>(&app_data_pt[MMU::page(si->lm.app_data) + data_pages]), si->pmm.app_extra, MMU::pages(si->lm.app_extra_size), MMU::page_tables(MMU::pages(si->lm.app_extra_size)), Flags::APP);
 
     db<Setup>(TRC) << "APPC_PT=" << *reinterpret_cast<Page_Table *>(app_code_pt) << endl;
     db<Setup>(TRC) << "APPD_PT=" << *reinterpret_cast<Page_Table *>(app_data_pt) << endl;
@@ -607,59 +723,41 @@ void Setup::setup_sys_pd()
     // Get the physical address for the System Page Directory
     PT_Entry * sys_pd = reinterpret_cast<PT_Entry *>(si->pmm.sys_pd);
 
-    // Clear the System Page Directory
-    memset(sys_pd, 0, sizeof(Page));
-
-    // Calculate the number of page tables needed to map the physical memory
-    unsigned int mem_size = MMU::pages(si->bm.mem_top - si->bm.mem_base);
-    unsigned int n_pts = MMU::page_tables(mem_size);
-    db<Setup>(INF) << "mem_size="<< mem_size << ",n_pts=" << n_pts << (void *) si->pmm.phy_mem_pts << ",syspd=" << (void *) si->pmm.sys_pd << "Size pte=" << sizeof(PT_Entry) << endl;
-    // Map the whole physical memory into the page tables pointed by phy_mem_pts
-    PT_Entry * pts = reinterpret_cast<PT_Entry *>(si->pmm.phy_mem_pts);
-
-    db<Setup>(INF) << &pts[0] <<  " to "<< &pts[(n_pts-1) * sizeof(Page_Table) + MMU::PT_ENTRIES] << endl;
+    // The System Page Directory was cleared by clear_frames()
 
-    configure_page_table_descriptors(pts, si->bm.mem_base, mem_size, n_pts, Flags::SYS);
+    // Calculate the number of sections needed to map the physical memory (sections need 1 MB aligned frames)
+    assert(!(si->bm.mem_base & (MMU::SECTION_SIZE - 1)));
+    unsigned int n_sections = (si->bm.mem_top - si->bm.mem_base + MMU::SECTION_SIZE - 1) / MMU::SECTION_SIZE;
+    db<Setup>(INF) << "mem_size=" << si->bm.mem_top - si->bm.mem_base << ",n_sections=" << n_sections << ",syspd=" << (void *) si->pmm.sys_pd << endl;
 
-    db<Setup>(INF) << "PHY_MEM_PT("<< (void *) pts <<")=" << *reinterpret_cast<Page_Table *>(pts) << endl; // if this print is removed, the config goes wrong
-    db<Setup>(INF) << "mem_size="<< mem_size <<",n_pts=" << n_pts << endl;
-
-    db<Setup>(INF) << "pts done" << endl;
     // Attach all physical memory starting at PHY_MEM
     if (PHY_MEM != RAM_BASE) {
-        assert((MMU::directory(MMU::align_directory(PHY_MEM)) + n_pts) < (MMU::PD_ENTRIES - 3)); // check if it would overwrite the OS
-        for(unsigned int i = MMU::directory(MMU::align_directory(PHY_MEM)), j = 0; i < MMU::directory(MMU::align_directory(PHY_MEM)) + n_pts; i++, j++)
-            sys_pd[i] = MMU::phy2pde(si->pmm.phy_mem_pts + j * sizeof(Page_Table));
+        assert((MMU::directory(MMU::align_directory(PHY_MEM)) + n_sections) < (MMU::PD_ENTRIES - 3)); // check if it would overwrite the OS
+        for(unsigned int i = MMU::directory(MMU::align_directory(PHY_MEM)), j = 0; i < MMU::directory(MMU::align_directory(PHY_MEM)) + n_sections; i++, j++)
+            sys_pd[i] = MMU::phy2section(si->bm.mem_base + j * MMU::SECTION_SIZE, Flags::SYS);
         db<Setup>(INF) << "sys pd PHY_MEM  done" << endl;
     }
 
     // Attach the portion of the physical memory used by Setup at SETUP
-    sys_pd[MMU::directory(SETUP)] =  MMU::phy2pde(si->pmm.phy_mem_pts);
+    sys_pd[MMU::directory(SETUP)] = MMU::phy2section(si->bm.mem_base, Flags::SYS);
     db<Setup>(INF) << "sys pd on SETUP directory = " << MMU::directory(SETUP) << endl;
 
     // Attach all physical memory starting at RAM_BASE
-    assert((MMU::directory(MMU::align_directory(RAM_BASE)) + n_pts) < (MMU::PD_ENTRIES - 2)); // check if it would overwrite the OS
-    for(unsigned int i = MMU::directory(MMU::align_directory(RAM_BASE)), j = 0; i < MMU::directory(MMU::align_directory(RAM_BASE)) + n_pts; i++, j++)
-        sys_pd[i] = MMU::phy2pde(si->pmm.phy_mem_pts + j * sizeof(Page_Table));
+    assert((MMU::directory(MMU::align_directory(RAM_BASE)) + n_sections) < (MMU::PD_ENTRIES - 2)); // check if it would overwrite the OS
+    for(unsigned int i = MMU::directory(MMU::align_directory(RAM_BASE)), j = 0; i < MMU::directory(MMU::align_directory(RAM_BASE)) + n_sections; i++, j++)
+        sys_pd[i] = MMU::phy2section(si->bm.mem_base + j * MMU::SECTION_SIZE, Flags::SYS);
     db<Setup>(INF) << "sys pd RAM_BASE done, dir= " << MMU::directory(RAM_BASE) << endl;
 
-    // Calculate the number of page tables needed to map the IO address space
-    unsigned int io_size = MMU::pages(si->bm.mio_top - si->bm.mio_base);
-    n_pts = MMU::page_tables(io_size);
-
-    db<Setup>(INF) << "starting io pts, npts=" << n_pts << endl;
-    // Map IO address space into the page tables pointed by io_pts
-    pts = reinterpret_cast<PT_Entry *>(si->pmm.io_pts);
-    configure_page_table_descriptors(pts, si->bm.mio_base, io_size, n_pts, Flags::IO);
-
-    db<Setup>(INF) << "IO_PTS("<< (void *) pts <<")=" << *reinterpret_cast<Page_Table *>(pts) << endl; // if this print is removed, the config g
-    db<Setup>(INF) << "io pts done" << endl;
+    // Calculate the number of sections needed to map the IO address space
+    assert(!(si->bm.mio_base & (MMU::SECTION_SIZE - 1)));
+    n_sections = (si->bm.mio_top - si->bm.mio_base + MMU::SECTION_SIZE - 1) / MMU::SECTION_SIZE;
+    db<Setup>(INF) << "io_size=" << si->bm.mio_top - si->bm.mio_base << ",n_sections=" << n_sections << endl;
 
     // Attach devices' memory at Memory_Map::IO
-    assert((MMU::directory(MMU::align_directory(IO)) + n_pts) < (MMU::PD_ENTRIES - 1)); // check if it would overwrite the OS
-    for(unsigned int i = MMU::directory(MMU::align_directory(IO)), j = 0; i < MMU::directory(MMU::align_directory(IO)) + n_pts; i++, j++)
-        sys_pd[i] = MMU::phy2pde((si->pmm.io_pts + j * sizeof(Page_Table)));
-    db<Setup>(INF) << "sys pd for io pts done" << endl;
+    assert((MMU::directory(MMU::align_directory(IO)) + n_sections) < (MMU::PD_ENTRIES - 1)); // check if it would overwrite the OS
+    for(unsigned int i = MMU::directory(MMU::align_directory(IO)), j = 0; i < MMU::directory(MMU::align_directory(IO)) + n_sections; i++, j++)
+        sys_pd[i] = MMU::phy2section(si->bm.mio_base + j * MMU::SECTION_SIZE, Flags::IO);
+    db<Setup>(INF) << "sys pd for io done" << endl;
 
     db<Setup>(INF) << "attach SYS pt on sys pd[sys]:" << MMU::directory(SYS) 
                     << ", with sys_pt[0] = " <<  hex << *((int *) si->pmm.sys_pt) << endl;
@@ -674,7 +772,7 @@ void Setup::setup_sys_pd()
     db<Setup>(INF) << "attach SYS on sys pd done" << endl;
 
     // Attach the first APPLICATION CODE (i.e. app_code_pt)
-    n_pts = MMU::page_tables(MMU::pages(si->lm.app_code_size));
+    unsigned int n_pts = MMU::page_tables(MMU::pages(si->lm.app_code_size));
     for(unsigned int i = MMU::directory(MMU::align_directory(si->lm.app_code)), j = 0; i < MMU::directory(MMU::align_directory(si->lm.app_code)) + n_pts; i++, j++)
         sys_pd[i] = MMU::phy2pde(si->pmm.app_code_pts + j * sizeof(Page_Table));
 
@@ -742,6 +840,9 @@ void Setup::load_parts()
     memcpy(reinterpret_cast<void *>(SYS_INFO), si, sizeof(System_Info));
     si = reinterpret_cast<System_Info *>(SYS_INFO);
 
+    // On multicore, clear_frames() has already zeroed the data segments' frames
+    bool zeroed = (si->bm.n_cpus > 1);
+
     // Load INIT
     if(si->lm.has_ini) {
         db<Setup>(TRC) << "Setup::load_init()" << endl;
@@ -776,7 +877,7 @@ void Setup::load_parts()
             panic();
         }
         for(int i = 2; i < sys_elf->segments(); i++) {
-            if(sys_elf->load_segment(i) < 0) {
+            if(sys_elf->load_segment(i, 0, !zeroed) < 0) {
                 db<Setup>(ERR) << "OS data segment was corrupted during SETUP!" << endl;
                 panic();
             }
@@ -798,7 +899,7 @@ void Setup::load_parts()
             panic();
         }
         for(int i = 1; i < app_elf->segments(); i++) {
-            if(app_elf->load_segment(i) < 0) {
+            if(app_elf->load_segment(i, 0, !zeroed) < 0) {
                 db<Setup>(ERR) << "Application data segment was corrupted during SETUP!" << endl;
                 panic();
             }
@@ -810,7 +911,8 @@ void Setup::load_parts()
         db<Setup>(TRC) << "Setup::load_extra()" << endl;
         if(Traits<Setup>::hysterically_debugged)
             db<Setup>(INF) << "Setup:APP_EXTRA:" << MMU::Translation(si->lm.app_extra) << endl;
-        memcpy(reinterpret_cast<void *>(si->lm.app_extra), &bi[si->bm.extras_offset], si->lm.app_extra_size);
+        if(si->pmm.app_extra != reinterpret_cast<unsigned int>(&bi[si->bm.extras_offset])) // not mapped in place
+            memcpy(reinterpret_cast<void *>(si->lm.app_extra), &bi[si->bm.extras_offset], si->lm.app_extra_size);
     }
 }
 
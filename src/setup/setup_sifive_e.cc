@@ -100,6 +100,8 @@ Setup::Setup()
     if(Traits<System>::multitask) {
         bi = reinterpret_cast<char *>(IMAGE);
         si = reinterpret_cast<System_Info *>(&__boot_time_system_info);
+        if(CPU::id() == 0)
+            si->bt.reset(); // this SETUP does not stamp its phases, INIT does
 
         Display::init();
         db<Setup>(TRC) << "Setup(bi=" << reinterpret_cast<void *>(bi) << ",sp=" << reinterpret_cast<void *>(CPU::sp()) << ")" << endl;
@@ -37,6 +37,7 @@ private:
     static const unsigned int SYS_CODE  = Memory_Map::SYS_CODE;
     static const unsigned int SYS_DATA  = Memory_Map::SYS_DATA;
     static const unsigned int SYS_STACK = Memory_Map::SYS_STACK;
+    static const unsigned int SYS_HEAP  = Memory_Map::SYS_HEAP;
     static const unsigned int APP_CODE  = Memory_Map::APP_CODE;
     static const unsigned int APP_DATA  = Memory_Map::APP_DATA;
 
@@ -75,6 +76,15 @@ private:
 
     void panic() { Machine::panic(); }
 
+    // Boot trace stamps come from the CLINT's mtime (i.e. the TSC), which is reachable both before and after paging
+    void stamp(Boot_Trace::Phase phase) {
+        if(Traits<Tracer>::boot_trace)
+            si->bt.stamp(phase, TSC::time_stamp());
+    }
+
+    // The system page tables are contiguous and map SYS up to SYS_HEAP
+    static unsigned int sys_page(unsigned int addr) { return MMU::pages(addr - SYS); }
+
 private:
     char * bi;
     System_Info * si;
@@ -93,6 +103,10 @@ Setup::Setup()
     if(Traits<System>::multitask) {
         bi = reinterpret_cast<char *>(IMAGE);
         si = reinterpret_cast<System_Info *>(&boot_time_system_info);
+        if(CPU::id() == 0) {
+            si->bt.reset();
+            stamp(Boot_Trace::SETUP);
+        }
 
         Display::init();
         db<Setup>(TRC) << "Setup(bi=" << reinterpret_cast<void *>(bi) << ",sp=" << reinterpret_cast<void *>(CPU::sp()) << ")" << endl;
@@ -103,7 +117,9 @@ Setup::Setup()
 
         if(CPU::id() == 0) { // Boot strap CPU (BSP)
             // Build the memory model
+            stamp(Boot_Trace::BUILD_LM);
             build_lm();
+            stamp(Boot_Trace::BUILD_PMM);
             build_pmm();
 
             // Relocate the machine to supervisor handler
@@ -113,14 +129,17 @@ Setup::Setup()
             say_hi();
 
             // Configure the memory model defined above
+            stamp(Boot_Trace::PAGE_TABLES);
             setup_sys_pt();
             setup_sys_pd();
 
             // Enable paging
             // We won't be able to print anything before the remap() bellow
+            stamp(Boot_Trace::PAGING);
             enable_paging();
 
             // Load EPOS parts (e.g. INIT, SYSTEM, APP)
+            stamp(Boot_Trace::LOAD_PARTS);
             load_parts();
 
             // Signalize other CPUs that paging is up
@@ -334,27 +353,17 @@ void Setup::build_pmm()
     top_page -= 1;
     si->pmm.sys_info = top_page * sizeof(Page);
 
-    // System Page Table (1 x sizeof(Page))
-    top_page -= 1;
+    // System Page Tables (2 x sizeof(Page), since Sv39 page tables map only 2 MB)
+    top_page -= MMU::page_tables(MMU::pages(SYS_HEAP - SYS));
     si->pmm.sys_pt = top_page * sizeof(Page);
 
-    // System Page Directory (1 x sizeof(Page))
-    top_page -= 1;
+    // System Page Directory (5 x sizeof(Page), the root table and the four level-1 tables it points to)
+    top_page -= sizeof(Page_Directory) / sizeof(Page);
     si->pmm.sys_pd = top_page * sizeof(Page);
 
-    // Page tables to map the whole physical memory
-    // = NP/NPTE_PT * sizeof(Page)
-    //   NP = size of physical memory in pages
-    //   NPTE_PT = number of page table entries per page table
-    top_page -= MMU::page_tables(MMU::pages(si->bm.mem_top - si->bm.mem_base));
-    si->pmm.phy_mem_pts = top_page * sizeof(Page);
-
-    // Page tables to map the IO address space
-    // = NP/NPTE_PT * sizeof(Page)
-    // NP = size of I/O address space in pages
-    // NPTE_PT = number of page table entries per page table
-    top_page -= MMU::page_tables(MMU::pages(si->bm.mio_top - si->bm.mio_base));
-    si->pmm.io_pts = top_page * sizeof(Page);
+    // The physical memory and the I/O space are mapped with megapages straight from the directory, so no page tables
+    si->pmm.phy_mem_pts = 0;
+    si->pmm.io_pts = 0;
 
     // SYSTEM code segment
     top_page -= MMU::pages(si->lm.sys_code_size);
@@ -437,37 +446,41 @@ void Setup::setup_sys_pt()
                    << ",syss={b=" << (void *)si->pmm.sys_stack << ",s=" << MMU::pages(si->lm.sys_stack_size) << "}"
                    << "})" << endl;
 
-    // Get the physical address for the System Page Table
+    // Get the physical address for the System Page Tables
     PT_Entry * sys_pt = reinterpret_cast<PT_Entry *>(si->pmm.sys_pt);
 
-    // Clear the System Page Table
-    memset(sys_pt, 0, sizeof(Page));
+    // Clear the System Page Tables, which map SYS contiguously (index them with sys_page())
+    unsigned int n_pts = MMU::page_tables(MMU::pages(SYS_HEAP - SYS));
+    memset(sys_pt, 0, n_pts * sizeof(Page));
 
     // System Info
-    sys_pt[MMU::page(SYS_INFO)] = MMU::phy2pte(si->pmm.sys_info, Flags::SYS);
+    sys_pt[sys_page(SYS_INFO)] = MMU::phy2pte(si->pmm.sys_info, Flags::SYS);
 
-    // Set an entry to this page table, so the system can access it later
-    sys_pt[MMU::page(SYS_PT)] = MMU::phy2pte(si->pmm.sys_pt, Flags::SYS);
+    // Set entries to these page tables, so the system can access them later
+    for(unsigned int i = 0; i < n_pts; i++)
+        sys_pt[sys_page(SYS_PT) + i] = MMU::phy2pte(si->pmm.sys_pt + i * sizeof(Page), Flags::SYS);
 
     // System Page Directory
-    sys_pt[MMU::page(SYS_PD)] = MMU::phy2pte(si->pmm.sys_pd, Flags::SYS);
+    for(unsigned int i = 0; i < sizeof(Page_Directory) / sizeof(Page); i++)
+        sys_pt[sys_page(SYS_PD) + i] = MMU::phy2pte(si->pmm.sys_pd + i * sizeof(Page), Flags::SYS);
 
     unsigned int i;
-    PT_Entry aux;
+    Phy_Addr aux;
 
     // SYSTEM code
     for(i = 0, aux = si->pmm.sys_code; i < MMU::pages(si->lm.sys_code_size); i++, aux = aux + sizeof(Page))
-        sys_pt[MMU::page(SYS_CODE) + i] = MMU::phy2pte(aux, Flags::SYS);
+        sys_pt[sys_page(SYS_CODE) + i] = MMU::phy2pte(aux, Flags::SYS);
 
     // SYSTEM data
     for(i = 0, aux = si->pmm.sys_data; i < MMU::pages(si->lm.sys_data_size); i++, aux = aux + sizeof(Page))
-        sys_pt[MMU::page(SYS_DATA) + i] = MMU::phy2pte(aux, Flags::SYS);
+        sys_pt[sys_page(SYS_DATA) + i] = MMU::phy2pte(aux, Flags::SYS);
 
     // SYSTEM stack (used only during init and for the ukernel model)
     for(i = 0, aux = si->pmm.sys_stack; i < MMU::pages(si->lm.sys_stack_size); i++, aux = aux + sizeof(Page))
-        sys_pt[MMU::page(SYS_STACK) + i] = MMU::phy2pte(aux, Flags::SYS);
+        sys_pt[sys_page(SYS_STACK) + i] = MMU::phy2pte(aux, Flags::SYS);
 
-    db<Setup>(INF) << "SYS_PT=" << *reinterpret_cast<Page_Table *>(sys_pt) << endl;
+    for(i = 0; i < n_pts; i++)
+        db<Setup>(INF) << "SYS_PT[" << i << "]=" << *reinterpret_cast<Page_Table *>(si->pmm.sys_pt + i * sizeof(Page)) << endl;
 }
 
 void Setup::setup_sys_pd()
@@ -495,49 +508,51 @@ void Setup::setup_sys_pd()
                    << ",fr2t="  << (void *)si->pmm.free2_top
                    << "})" << endl;
 
-    // Get the physical address for the System Page Directory
-    PT_Entry * sys_pd = reinterpret_cast<PT_Entry *>(si->pmm.sys_pd);
+    // Get the physical address for the System Page Directory: the root table followed by the four level-1 tables
+    PT_Entry * root = reinterpret_cast<PT_Entry *>(si->pmm.sys_pd);
+    PT_Entry * sys_pd = root + MMU::PT_ENTRIES;
 
     // Clear the System Page Directory
-    memset(sys_pd, 0, sizeof(Page));
+    memset(root, 0, sizeof(Page_Directory));
 
-    // Calculate the number of page tables needed to map the physical memory
-    unsigned int mem_size = MMU::pages(si->bm.mem_top - si->bm.mem_base);
-    int n_pts = MMU::page_tables(mem_size);
+    // Point the root table at the level-1 tables (RV64 sign-extends addresses above 2 GB, so those reach the top of the root)
+    for(unsigned int i = 0; i < MMU::PD_ENTRIES / MMU::PT_ENTRIES; i++) {
+        root[i] = MMU::phy2pde(si->pmm.sys_pd + (i + 1) * sizeof(Page));
+        if(i >= MMU::PD_ENTRIES / MMU::PT_ENTRIES / 2)
+            root[MMU::PT_ENTRIES - MMU::PD_ENTRIES / MMU::PT_ENTRIES + i] = root[i];
+    }
 
-    // Map the whole physical memory into the page tables pointed by phy_mem_pts
-    PT_Entry * pts = reinterpret_cast<PT_Entry *>(si->pmm.phy_mem_pts);
-    for(unsigned int i = 0; i < mem_size; i++)
-        pts[i] = MMU::phy2pte((si->bm.mem_base + i * sizeof(Page)), Flags::SYS);
+    // Physical memory and I/O space are mapped with megapages, i.e. leaves in the directory, each covering what a page table would
+    const unsigned int MEGA_PAGE = MMU::PT_ENTRIES * sizeof(Page);
+    assert(!(si->bm.mem_base % MEGA_PAGE) && !(si->bm.mio_base % MEGA_PAGE)); // megapages must be naturally aligned
+
+    // Calculate the number of megapages needed to map the physical memory
+    unsigned int n_pts = MMU::page_tables(MMU::pages(si->bm.mem_top - si->bm.mem_base));
 
     // Attach all physical memory starting at PHY_MEM
     assert((MMU::directory(MMU::align_directory(PHY_MEM)) + n_pts) < (MMU::PD_ENTRIES - 4)); // check if it would overwrite the OS
     for(unsigned int i = MMU::directory(MMU::align_directory(PHY_MEM)), j = 0; i < MMU::directory(MMU::align_directory(PHY_MEM)) + n_pts; i++, j++)
-        sys_pd[i] = MMU::phy2pde((si->pmm.phy_mem_pts + j * sizeof(Page)));
+        sys_pd[i] = MMU::phy2pte(si->bm.mem_base + j * MEGA_PAGE, Flags::SYS);
 
     // Attach all physical memory starting at RAM_BASE
     assert((MMU::directory(MMU::align_directory(RAM_BASE)) + n_pts) < (MMU::PD_ENTRIES - 4)); // check if it would overwrite the OS
     for(unsigned int i = MMU::directory(MMU::align_directory(RAM_BASE)), j = 0; i < MMU::directory(MMU::align_directory(RAM_BASE)) + n_pts; i++, j++)
-        sys_pd[i] = MMU::phy2pde((si->pmm.phy_mem_pts + j * sizeof(Page)));
-
-    // Calculate the number of page tables needed to map the IO address space
-    unsigned int io_size = MMU::pages(si->bm.mio_top - si->bm.mio_base);
-    n_pts = MMU::page_tables(io_size);
+        sys_pd[i] = MMU::phy2pte(si->bm.mem_base + j * MEGA_PAGE, Flags::SYS);
 
-    // Map IO address space into the page tables pointed by io_pts
-    pts = reinterpret_cast<PT_Entry *>(si->pmm.io_pts);
-    for(unsigned int i = 0; i < io_size; i++)
-        pts[i] = MMU::phy2pte((si->bm.mio_base + i * sizeof(Page)), Flags::IO);
+    // Calculate the number of megapages needed to map the IO address space
+    n_pts = MMU::page_tables(MMU::pages(si->bm.mio_top - si->bm.mio_base));
 
     // Attach devices' memory at Memory_Map::IO
     assert((MMU::directory(MMU::align_directory(IO)) + n_pts) < (MMU::PD_ENTRIES - 3)); // check if it would overwrite the OS
     for(unsigned int i = MMU::directory(MMU::align_directory(IO)), j = 0; i < MMU::directory(MMU::align_directory(IO)) + n_pts; i++, j++)
-        sys_pd[i] = MMU::phy2pde((si->pmm.io_pts + j * sizeof(Page)));
+        sys_pd[i] = MMU::phy2pte(si->bm.mio_base + j * MEGA_PAGE, Flags::IO);
 
     // Attach the OS (i.e. sys_pt)
-    sys_pd[MMU::directory(SYS)] = MMU::phy2pde(si->pmm.sys_pt);
+    n_pts = MMU::page_tables(MMU::pages(SYS_HEAP - SYS));
+    for(unsigned int i = 0; i < n_pts; i++)
+        sys_pd[MMU::directory(SYS) + i] = MMU::phy2pde(si->pmm.sys_pt + i * sizeof(Page));
 
-    db<Setup>(INF) << "SYS_PD=" << *reinterpret_cast<Page_Table *>(sys_pd) << endl;
+    db<Setup>(INF) << "SYS_PD=" << *reinterpret_cast<Page_Directory *>(root) << endl;
 }
 
 void Setup::setup_m2s()
@@ -21,6 +21,6 @@ extern "C" {
 
     // Utility-related methods that differ from kernel and user space.
     // OStream
-    void _print(const char * s) { Display::puts(s); }
+    void _print(const char * s) { System::print(s); }
 }
 
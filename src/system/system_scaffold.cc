@@ -19,5 +19,33 @@ System_Info * System::_si = reinterpret_cast<System_Info *>(Memory_Map::SYS_INFO
 char System::_preheap[];
 Segment * System::_heap_segment;
 Heap * System::_heap;
+System::Log System::_log;
+unsigned int System::_log_reported;
+
+// System class methods
+void System::print(const char * s)
+{
+    if(Traits<Debug>::buffered && !This_Thread::booting())
+        _log.put(s);
+    else
+        Display::puts(s);
+}
+
+void System::flush()
+{
+    if(Traits<Debug>::buffered) {
+        _log.drain(&Display::puts);
+
+        unsigned int dropped = _log.dropped();
+        if(dropped != _log_reported) {
+            char number[16];
+            number[utoa(dropped - _log_reported, number)] = '\0';
+            Display::puts("<");
+            Display::puts(number);
+            Display::puts(" log records dropped>\n");
+            _log_reported = dropped;
+        }
+    }
+}
 
 __END_SYS
@@ -3,10 +3,11 @@
 #include <architecture/cpu.h>
 #include <utility/elf.h>
 #include <utility/string.h>
+#include <utility/lz4.h>
 
 __BEGIN_UTIL
 
-int ELF::load_segment(int i, Elf32_Addr addr)
+int ELF::load_segment(int i, Elf32_Addr addr, bool clear)
 {
     if((i > segments()) || (segment_type(i) != PT_LOAD))
         return 0;
@@ -14,8 +15,16 @@ int ELF::load_segment(int i, Elf32_Addr addr)
     char * src = reinterpret_cast<char *>(CPU::Reg(this) + seg(i)->p_offset);
     char * dst = reinterpret_cast<char *>((addr) ? addr : segment_address(i));
 
-    memcpy(dst, src, seg(i)->p_filesz);
-    memset(dst + seg(i)->p_filesz, 0, seg(i)->p_memsz - seg(i)->p_filesz);
+    // Compressed segments are inflated straight into their final place
+    int size = seg(i)->p_filesz;
+    if(seg(i)->p_flags & LZ4::PF_LZ4) {
+        size = LZ4::decompress(dst, src, seg(i)->p_filesz, seg(i)->p_memsz);
+        if(size < 0)
+            return -1;
+    } else
+        memcpy(dst, src, size);
+    if(clear)
+        memset(dst + size, 0, seg(i)->p_memsz - size);
 
     return seg(i)->p_memsz;
 }
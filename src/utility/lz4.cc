@@ -0,0 +1,69 @@
+// EPOS LZ4 Utility Implementation
+
+#include <utility/lz4.h>
+#include <utility/string.h>
+
+__BEGIN_UTIL
+
+int LZ4::decompress(void * dst, const void * src, unsigned int size, unsigned int capacity)
+{
+    const unsigned char * in = reinterpret_cast<const unsigned char *>(src);
+    const unsigned char * end = in + size;
+    unsigned char * out = reinterpret_cast<unsigned char *>(dst);
+    unsigned char * limit = out + capacity;
+
+    while(in < end) {
+        unsigned int token = *in++;
+
+        // Literals
+        unsigned int length = token >> 4;
+        if(length == 15) {
+            unsigned char b;
+            do {
+                if(in >= end)
+                    return -1;
+                b = *in++;
+                length += b;
+            } while(b == 255);
+        }
+        if((length > static_cast<unsigned int>(end - in)) || (length > static_cast<unsigned int>(limit - out)))
+            return -1;
+        memcpy(out, in, length);
+        in += length;
+        out += length;
+
+        if(in == end) // the last sequence has literals only
+            break;
+
+        // Match
+        if(end - in < 2)
+            return -1;
+        unsigned int offset = in[0] | (in[1] << 8);
+        in += 2;
+        if(!offset || (offset > static_cast<unsigned int>(out - reinterpret_cast<unsigned char *>(dst))))
+            return -1;
+
+        length = token & 15;
+        if(length == 15) {
+            unsigned char b;
+            do {
+                if(in >= end)
+                    return -1;
+                b = *in++;
+                length += b;
+            } while(b == 255);
+        }
+        length += MIN_MATCH;
+        if(length > static_cast<unsigned int>(limit - out))
+            return -1;
+
+        // Matches may overlap the bytes they produce (e.g. runs), so copy forward byte by byte
+        const unsigned char * from = out - offset;
+        while(length--)
+            *out++ = *from++;
+    }
+
+    return out - reinterpret_cast<unsigned char *>(dst);
+}
+
+__END_UTIL
@@ -16,8 +16,10 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <ctype.h>
+#include <elf.h>
 
 #include <system/info.h>
+#include <utility/lz4.h>
 
 // CONSTANTS
 static const unsigned int MAX_SI_LEN = 512;
@@ -50,10 +52,13 @@ struct Configuration
     bool           si_in_setup;
     unsigned int   boot_length_min;
     unsigned int   boot_length_max;
+    bool           compress;   // LZ4-compress the segments of INIT, SYSTEM and the first APPLICATION
 };
 
 // System_Info
 typedef _SYS::System_Info System_Info;
+typedef _SYS::Image_Index Image_Index;
+typedef _UTIL::LZ4 LZ4;
 
 // PROTOTYPES
 bool parse_config(FILE * cfg_file, Configuration * cfg);
@@ -64,12 +69,16 @@ bool file_exist(char *file);
 
 int put_buf(int fd_out, void * buf, int size);
 int put_file(int fd_out, char * file);
-int pad(int fd_out, int size);
+int put_extra(int fd_out, char * file);
+int put_elf(int fd_out, char * file);
+unsigned int lz4_compress(const unsigned char * src, unsigned int size, unsigned char * dst);
+int pad(int fd_out, int size, char fill = '\1');
 bool lil_endian();
 
 template<typename T> void invert(T &n);
 template<typename T> int put_number(int fd, T num);
 template<typename T> bool add_boot_map(int fd_out, System_Info * si);
+template<typename Ehdr, typename Phdr> char * relayout(char * elf, unsigned int size, Image_Index * index);
 
 // GLOBALS
 FILE * out;
@@ -81,6 +90,9 @@ Configuration CONFIG;
 //=============================================================================
 int main(int argc, char **argv)
 {
+    // Default: no compression
+    CONFIG.compress = false;
+
     // Defult Space
     CONFIG.space_x = -1; // dynamic
     CONFIG.space_y = -1; // dynamic
@@ -96,7 +108,7 @@ int main(int argc, char **argv)
         error = true;
 
     int opt;
-    while((opt = getopt(argc, argv, "sx:y:z:")) != -1) {
+    while((opt = getopt(argc, argv, "csx:y:z:")) != -1) {
         switch(opt) {
         case 's': {
             FILE * nul = fopen("/dev/null", "w");
@@ -107,6 +119,9 @@ int main(int argc, char **argv)
             out = nul;
             err = nul;
         } break;
+        case 'c':
+            CONFIG.compress = true;
+            break;
         case 'x':
             CONFIG.space_x = atoi(optarg);
             break;
@@ -124,7 +139,7 @@ int main(int argc, char **argv)
         error = true;
 
     if(error) {
-        fprintf(err, "Usage: %s [-s] [-x X] [-y Y] [-z Z] <EPOS root> <boot image> <app1> <app2> ...\n", argv[0]);
+        fprintf(err, "Usage: %s [-c] [-s] [-x X] [-y Y] [-z Z] <EPOS root> <boot image> <app1> <app2> ...\n", argv[0]);
         return 1;
     }
 
@@ -227,32 +242,32 @@ int main(int argc, char **argv)
         si.bm.init_offset = image_size - boot_size;
         sprintf(file, "%s/img/init_%s", argv[optind], CONFIG.mmod);
         fprintf(out, "    Adding init \"%s\":", file);
-        image_size += put_file(fd_img, file);
+        image_size += put_elf(fd_img, file);
 
         // Add SYSTEM
         si.bm.system_offset = image_size - boot_size;
         sprintf(file, "%s/img/system_%s", argv[optind], CONFIG.mmod);
         fprintf(out, "    Adding system \"%s\":", file);
-        image_size += put_file(fd_img, file);
+        image_size += put_elf(fd_img, file);
     }
 
     // Add application(s) and data
     si.bm.application_offset = image_size - boot_size;
     fprintf(out, "    Adding application \"%s\":", argv[optind + 2]);
-    image_size += put_file(fd_img, argv[optind + 2]);
+    image_size += put_elf(fd_img, argv[optind + 2]);
     if((argc - optind) == 3) // single APP
         si.bm.extras_offset = -1;
-    else { // multiple APPs or data
+    else { // multiple APPs or data (in page-aligned records, so they can be mapped in place)
+        unsigned int misalignment = (image_size - boot_size) % Image_Index::PAGE_SIZE;
+        if(misalignment)
+            image_size += pad(fd_img, Image_Index::PAGE_SIZE - misalignment, '\0');
         si.bm.extras_offset = image_size - boot_size;
-        struct stat file_stat;
         for(int i = optind + 3; i < argc; i++) {
             fprintf(out, "    Adding file \"%s\":", argv[i]);
-            stat(argv[i], &file_stat);
-            image_size += put_number(fd_img, file_stat.st_size);
-            image_size += put_file(fd_img, argv[i]);
+            image_size += put_extra(fd_img, argv[i]);
         }
         // Signalize last application by setting its size to 0
-        image_size += put_number(fd_img, 0);
+        image_size += put_number(fd_img, static_cast<unsigned int>(0));
     }
 
     // Add the size of the image to the Boot_Map in System_Info (excluding BOOT)
@@ -683,6 +698,360 @@ int put_file(int fd_out, char * file)
     return stat.st_size;
 }
 
+//=============================================================================
+// PUT_ELF
+//=============================================================================
+// Adds an ELF file that SETUP loads with ELF::load_segment(). With -c, each
+// PT_LOAD segment is LZ4-compressed (if that makes it smaller) and flagged
+// with LZ4::PF_LZ4, so SETUP inflates it straight into its final address.
+// The ELF and program headers stay in the clear, the compressed segments
+// follow them and section headers are dropped.
+int put_elf(int fd_out, char * file)
+{
+    if(!CONFIG.compress)
+        return put_file(fd_out, file);
+
+    int fd_in;
+    struct stat stat;
+    char * buffer;
+
+    fd_in = open(file, O_RDONLY);
+    if(fd_in < 0) {
+        fprintf(out, " failed! (open)\n");
+        return 0;
+    }
+
+    if(fstat(fd_in, &stat) < 0)  {
+        fprintf(out, " failed! (stat)\n");
+        return 0;
+    }
+
+    buffer = (char *) malloc(stat.st_size);
+    if(!buffer) {
+        fprintf(out, " failed! (malloc)\n");
+        return 0;
+    }
+
+    if(read(fd_in, buffer, stat.st_size) < 0) {
+        fprintf(out, " failed! (read)\n");
+        free(buffer);
+        return 0;
+    }
+    close(fd_in);
+
+    Elf32_Ehdr * ehdr = reinterpret_cast<Elf32_Ehdr *>(buffer);
+    if((stat.st_size < (off_t)sizeof(Elf32_Ehdr)) || memcmp(ehdr->e_ident, ELFMAG, SELFMAG) || (ehdr->e_ident[EI_CLASS] != ELFCLASS32)
+       || (ehdr->e_ident[EI_DATA] != (lil_endian() ? ELFDATA2LSB : ELFDATA2MSB)) || (ehdr->e_phentsize != sizeof(Elf32_Phdr))
+       || (ehdr->e_phoff + ehdr->e_phnum * sizeof(Elf32_Phdr) > (unsigned int)stat.st_size)) {
+        free(buffer);
+        fprintf(out, " (not compressed)");
+        return put_file(fd_out, file);
+    }
+    Elf32_Phdr * phdr = reinterpret_cast<Elf32_Phdr *>(buffer + ehdr->e_phoff);
+
+    // Worst case: every segment incompressible
+    unsigned int headers = sizeof(Elf32_Ehdr) + ehdr->e_phnum * sizeof(Elf32_Phdr);
+    char * image = (char *) calloc(1, headers + stat.st_size + ehdr->e_phnum * 4);
+    unsigned char * block = (unsigned char *) malloc(stat.st_size + stat.st_size / 255 + 16);
+    if(!image || !block) {
+        fprintf(out, " failed! (malloc)\n");
+        free(image);
+        free(block);
+        free(buffer);
+        return 0;
+    }
+
+    Elf32_Ehdr * new_ehdr = reinterpret_cast<Elf32_Ehdr *>(image);
+    Elf32_Phdr * new_phdr = reinterpret_cast<Elf32_Phdr *>(image + sizeof(Elf32_Ehdr));
+    memcpy(new_ehdr, ehdr, sizeof(Elf32_Ehdr));
+    memcpy(new_phdr, phdr, ehdr->e_phnum * sizeof(Elf32_Phdr));
+    new_ehdr->e_phoff = sizeof(Elf32_Ehdr);
+    new_ehdr->e_shoff = 0;
+    new_ehdr->e_shnum = 0;
+    new_ehdr->e_shstrndx = SHN_UNDEF;
+
+    unsigned int top = headers;
+    unsigned int raw = 0;
+    for(unsigned int i = 0; i < ehdr->e_phnum; i++) {
+        if((phdr[i].p_type != PT_LOAD) || !phdr[i].p_filesz || (phdr[i].p_offset + phdr[i].p_filesz > (unsigned int)stat.st_size)) {
+            new_phdr[i].p_offset = 0;
+            new_phdr[i].p_filesz = 0;
+            continue;
+        }
+
+        top = (top + 3) & ~3;
+        unsigned int size = lz4_compress(reinterpret_cast<unsigned char *>(buffer + phdr[i].p_offset), phdr[i].p_filesz, block);
+        if(size < phdr[i].p_filesz) {
+            memcpy(image + top, block, size);
+            new_phdr[i].p_filesz = size;
+            new_phdr[i].p_flags |= LZ4::PF_LZ4;
+        } else {
+            memcpy(image + top, buffer + phdr[i].p_offset, phdr[i].p_filesz);
+            size = phdr[i].p_filesz;
+        }
+        new_phdr[i].p_offset = top;
+        top += size;
+        raw += phdr[i].p_filesz;
+    }
+
+    int written = put_buf(fd_out, image, top);
+
+    free(block);
+    free(image);
+    free(buffer);
+
+    fprintf(out, " done (%d -> %d bytes, %d bytes of segments).\n", (int)stat.st_size, written, raw);
+
+    return written;
+}
+
+//=============================================================================
+// LZ4_COMPRESS
+//=============================================================================
+// Greedy LZ4 block compressor (hash of the next 4 bytes into the last position
+// they were seen at). Respects the format's end-of-block restrictions, so any
+// LZ4 decoder (including LZ4::decompress()) can inflate its output.
+unsigned int lz4_compress(const unsigned char * src, unsigned int size, unsigned char * dst)
+{
+    static const unsigned int HASH_BITS = 16;
+    static unsigned int table[1 << HASH_BITS]; // position + 1 (0 => empty)
+
+    memset(table, 0, sizeof(table));
+
+    unsigned char * out = dst;
+    unsigned int anchor = 0;
+    unsigned int i = 0;
+
+    while(size >= LZ4::MATCH_LIMIT && i <= size - LZ4::MATCH_LIMIT) {
+        unsigned int sequence;
+        memcpy(&sequence, &src[i], 4);
+        unsigned int hash = (sequence * 2654435761U) >> (32 - HASH_BITS);
+        unsigned int candidate = table[hash];
+        table[hash] = i + 1;
+
+        if(!candidate || (i - (candidate - 1) > LZ4::MAX_OFFSET) || memcmp(&src[candidate - 1], &src[i], 4)) {
+            i++;
+            continue;
+        }
+        candidate--;
+
+        unsigned int match = LZ4::MIN_MATCH;
+        while((i + match < size - LZ4::LAST_LITERALS) && (src[candidate + match] == src[i + match]))
+            match++;
+
+        // Token, literals and match
+        unsigned int literals = i - anchor;
+        unsigned char * token = out++;
+        *token = ((literals < 15) ? literals : 15) << 4;
+        if(literals >= 15) {
+            unsigned int n = literals - 15;
+            for(; n >= 255; n -= 255)
+                *out++ = 255;
+            *out++ = n;
+        }
+        memcpy(out, &src[anchor], literals);
+        out += literals;
+
+        unsigned int offset = i - candidate;
+        *out++ = offset & 0xff;
+        *out++ = offset >> 8;
+
+        unsigned int length = match - LZ4::MIN_MATCH;
+        *token |= (length < 15) ? length : 15;
+        if(length >= 15) {
+            unsigned int n = length - 15;
+            for(; n >= 255; n -= 255)
+                *out++ = 255;
+            *out++ = n;
+        }
+
+        i += match;
+        anchor = i;
+    }
+
+    // Last sequence (literals only)
+    unsigned int literals = size - anchor;
+    *out++ = ((literals < 15) ? literals : 15) << 4;
+    if(literals >= 15) {
+        unsigned int n = literals - 15;
+        for(; n >= 255; n -= 255)
+            *out++ = 255;
+        *out++ = n;
+    }
+    memcpy(out, &src[anchor], literals);
+    out += literals;
+
+    return out - dst;
+}
+
+//=============================================================================
+// PUT_EXTRA
+//=============================================================================
+// Extra files go in records made of an Image_Index page followed by the file,
+// padded to a page boundary. 32-bit ELF files in the host's byte order are
+// relaid out so that each PT_LOAD segment lands at a file offset congruent to
+// its virtual address (see relayout()); anything else is stored as is.
+int put_extra(int fd_out, char * file)
+{
+    int fd_in;
+    struct stat stat;
+    char * buffer;
+
+    fd_in = open(file, O_RDONLY);
+    if(fd_in < 0) {
+        fprintf(out, " failed! (open)\n");
+        return 0;
+    }
+
+    if(fstat(fd_in, &stat) < 0)  {
+        fprintf(out, " failed! (stat)\n");
+        return 0;
+    }
+
+    buffer = (char *) malloc(stat.st_size);
+    if(!buffer) {
+        fprintf(out, " failed! (malloc)\n");
+        return 0;
+    }
+
+    if(read(fd_in, buffer, stat.st_size) < 0) {
+        fprintf(out, " failed! (read)\n");
+        free(buffer);
+        return 0;
+    }
+    close(fd_in);
+
+    Image_Index index;
+    memset(&index, 0, sizeof(Image_Index));
+    index.file_size = stat.st_size;
+
+    char * image = buffer;
+    unsigned char * ident = reinterpret_cast<unsigned char *>(buffer);
+    if((stat.st_size > (off_t)sizeof(Elf32_Ehdr)) && !memcmp(ident, ELFMAG, SELFMAG) && (ident[EI_CLASS] == ELFCLASS32)
+       && (ident[EI_DATA] == (lil_endian() ? ELFDATA2LSB : ELFDATA2MSB))) {
+        char * relaid = relayout<Elf32_Ehdr, Elf32_Phdr>(buffer, stat.st_size, &index);
+        if(relaid)
+            image = relaid;
+        else
+            fprintf(out, " (not relaid)");
+    }
+
+    unsigned int file_size = index.file_size;
+    unsigned int padding = (Image_Index::PAGE_SIZE - file_size % Image_Index::PAGE_SIZE) % Image_Index::PAGE_SIZE;
+    index.file_offset = Image_Index::PAGE_SIZE;
+    index.size = index.file_offset + file_size + padding;
+
+    int size = 0;
+    size += put_number(fd_out, index.size);
+    size += put_number(fd_out, index.file_offset);
+    size += put_number(fd_out, index.file_size);
+    size += put_number(fd_out, index.segments);
+    for(unsigned int i = 0; i < Image_Index::MAX_SEGMENTS; i++) {
+        size += put_number(fd_out, index.segment[i].offset);
+        size += put_number(fd_out, index.segment[i].vaddr);
+        size += put_number(fd_out, index.segment[i].file_size);
+        size += put_number(fd_out, index.segment[i].memory_size);
+        size += put_number(fd_out, index.segment[i].flags);
+    }
+    size += pad(fd_out, index.file_offset - size, '\0');
+    size += put_buf(fd_out, image, file_size);
+    size += pad(fd_out, padding, '\0');
+
+    if(image != buffer)
+        free(image);
+    free(buffer);
+
+    fprintf(out, " done (%d segments).\n", index.segments);
+
+    return size;
+}
+
+//=============================================================================
+// RELAYOUT
+//=============================================================================
+// Builds a copy of an ELF image with the ELF header and the program headers
+// at the beginning, followed by each PT_LOAD segment at the first offset that
+// is congruent to its virtual address modulo the page size. Gaps are zeroed
+// (so the tail of a page past a segment reads as .bss) and section headers are
+// dropped. Fills the index and returns the new image (or 0 if it is invalid).
+template<typename Ehdr, typename Phdr>
+char * relayout(char * elf, unsigned int size, Image_Index * index)
+{
+    const unsigned int PAGE_SIZE = Image_Index::PAGE_SIZE;
+
+    Ehdr * ehdr = reinterpret_cast<Ehdr *>(elf);
+    if((ehdr->e_phentsize != sizeof(Phdr)) || (ehdr->e_phoff + ehdr->e_phnum * sizeof(Phdr) > size))
+        return 0;
+    Phdr * phdr = reinterpret_cast<Phdr *>(elf + ehdr->e_phoff);
+
+    unsigned int * offset = (unsigned int *) malloc(ehdr->e_phnum * sizeof(unsigned int));
+    if(!offset)
+        return 0;
+
+    unsigned int top = sizeof(Ehdr) + ehdr->e_phnum * sizeof(Phdr);
+    unsigned int loads = 0;
+    for(unsigned int i = 0; i < ehdr->e_phnum; i++) {
+        if(phdr[i].p_type != PT_LOAD)
+            continue;
+        if((phdr[i].p_offset + phdr[i].p_filesz > size) || (loads == Image_Index::MAX_SEGMENTS)) {
+            free(offset);
+            return 0;
+        }
+        offset[i] = (top & ~(PAGE_SIZE - 1)) + (phdr[i].p_vaddr & (PAGE_SIZE - 1));
+        if(offset[i] < top)
+            offset[i] += PAGE_SIZE;
+        top = offset[i] + phdr[i].p_filesz;
+        loads++;
+    }
+
+    char * image = (char *) calloc(1, top);
+    if(!image) {
+        free(offset);
+        return 0;
+    }
+
+    Ehdr * new_ehdr = reinterpret_cast<Ehdr *>(image);
+    Phdr * new_phdr = reinterpret_cast<Phdr *>(image + sizeof(Ehdr));
+    memcpy(new_ehdr, ehdr, sizeof(Ehdr));
+    memcpy(new_phdr, phdr, ehdr->e_phnum * sizeof(Phdr));
+    new_ehdr->e_phoff = sizeof(Ehdr);
+    new_ehdr->e_shoff = 0;
+    new_ehdr->e_shnum = 0;
+    new_ehdr->e_shstrndx = SHN_UNDEF;
+
+    index->segments = 0;
+    for(unsigned int i = 0; i < ehdr->e_phnum; i++) {
+        if(phdr[i].p_type == PT_LOAD) {
+            memcpy(image + offset[i], elf + phdr[i].p_offset, phdr[i].p_filesz);
+            new_phdr[i].p_offset = offset[i];
+
+            Image_Index::Segment * seg = &index->segment[index->segments++];
+            seg->offset = offset[i];
+            seg->vaddr = phdr[i].p_vaddr;
+            seg->file_size = phdr[i].p_filesz;
+            seg->memory_size = phdr[i].p_memsz;
+            seg->flags = phdr[i].p_flags;
+        } else if(phdr[i].p_type == PT_PHDR) {
+            new_phdr[i].p_offset = sizeof(Ehdr);
+        } else { // other segments keep pointing into the PT_LOAD that contains them (if any)
+            new_phdr[i].p_offset = 0;
+            new_phdr[i].p_filesz = 0;
+            for(unsigned int j = 0; j < ehdr->e_phnum; j++)
+                if((phdr[j].p_type == PT_LOAD) && (phdr[i].p_offset >= phdr[j].p_offset)
+                   && (phdr[i].p_offset + phdr[i].p_filesz <= phdr[j].p_offset + phdr[j].p_filesz)) {
+                    new_phdr[i].p_offset = offset[j] + (phdr[i].p_offset - phdr[j].p_offset);
+                    new_phdr[i].p_filesz = phdr[i].p_filesz;
+                    break;
+                }
+        }
+    }
+
+    free(offset);
+
+    index->file_size = top;
+    return image;
+}
+
 //=============================================================================
 // PUT_BUF
 //=============================================================================
@@ -715,7 +1084,7 @@ template<typename T> int put_number(int fd, T num)
 //=============================================================================
 // PAD
 //=============================================================================
-int pad(int fd, int size)
+int pad(int fd, int size, char fill)
 {
     if(!size)
         return 0;
@@ -726,7 +1095,7 @@ int pad(int fd, int size)
         return 0;
     }
 
-    memset(buffer, '\1', size);
+    memset(buffer, fill, size);
     if(write(fd, buffer, size) < 0) {
         fprintf(err, "Error: can't write to the boot image!\n");
         return 0;
@@ -0,0 +1,203 @@
+/*=======================================================================*/
+/* epostrace.cc                                                          */
+/*                                                                       */
+/* Desc: Tool to convert an EPOS binary event trace, as dumped to the    */
+/*       console by Tracer::dump(), into a Chrome/Perfetto JSON timeline */
+/*       (load it in chrome://tracing or ui.perfetto.dev).               */
+/*                                                                       */
+/* Parm: [console log (default stdin)] [JSON output (default stdout)]    */
+/*=======================================================================*/
+
+// Using only bare C to avoid conflicts with EPOS
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+// Constants
+const unsigned int LINE_SIZE = 256;
+const unsigned int MAX_CPUS = 16;
+const unsigned long long WRAP_32 = 1ULL << 32;
+
+// Must match Tracer::Event (include/tracer.h)
+enum Event {
+    THREAD_DISPATCH,
+    IRQ_ENTRY,
+    IRQ_EXIT,
+    SYSCALL_ENTRY,
+    SYSCALL_EXIT,
+    ALARM_HANDLER,
+    MUTEX_CONTENTION
+};
+
+// Interrupt handlers and alarms are shown in a lane of their own (thread ids are Thread pointers, never 0)
+const unsigned long IRQ_LANE = 0;
+
+// Globals
+FILE * out;
+unsigned long long frequency;
+bool first = true;
+unsigned long long origin;
+unsigned long long last;
+unsigned long long wraps;
+
+struct Running {
+    bool valid;
+    unsigned long thread;
+    double since;
+} running[MAX_CPUS];
+
+// Prototypes
+double timestamp(unsigned long long time);
+void event(const char * name, char ph, unsigned int cpu, unsigned long tid, double ts, const char * args = 0);
+void slice(unsigned int cpu, unsigned long tid, double begin, double end);
+
+int main(int argc, char **argv)
+{
+    FILE * in = stdin;
+    out = stdout;
+
+    if(argc > 1 && strcmp(argv[1], "-")) {
+        in = fopen(argv[1], "r");
+        if(!in) {
+            fprintf(stderr, "Error: could not open console log \"%s\"!\n", argv[1]);
+            return 1;
+        }
+    }
+    if(argc > 2) {
+        out = fopen(argv[2], "w");
+        if(!out) {
+            fprintf(stderr, "Error: could not create JSON file \"%s\"!\n", argv[2]);
+            return 1;
+        }
+    }
+
+    // Skip the console log up to the trace header
+    char line[LINE_SIZE];
+    unsigned int count = 0;
+    bool found = false;
+    while(fgets(line, LINE_SIZE, in))
+        if(sscanf(line, "#TRACE %llu %u", &frequency, &count) == 2) {
+            found = true;
+            break;
+        }
+    if(!found || !frequency) {
+        fprintf(stderr, "Error: no trace found in the console log!\n");
+        return 1;
+    }
+
+    fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    for(unsigned int i = 0; i < MAX_CPUS; i++) {
+        char args[LINE_SIZE];
+        snprintf(args, LINE_SIZE, "\"name\":\"CPU %u\"", i);
+        event("process_name", 'M', i, IRQ_LANE, 0, args);
+        event("thread_name", 'M', i, IRQ_LANE, 0, "\"name\":\"interrupts\"");
+    }
+
+    unsigned int records = 0;
+    double now = 0;
+    while(fgets(line, LINE_SIZE, in)) {
+        if(!strncmp(line, "#END", 4))
+            break;
+
+        unsigned long long time;
+        unsigned int type, cpu;
+        unsigned long thread, a, b;
+        if(sscanf(line, "%llu %u %u %lu %lu %lu", &time, &type, &cpu, &thread, &a, &b) != 6)
+            continue;
+        if(cpu >= MAX_CPUS) {
+            fprintf(stderr, "Warning: record %u refers to CPU %u, ignored!\n", records, cpu);
+            continue;
+        }
+
+        records++;
+        now = timestamp(time);
+
+        char name[LINE_SIZE];
+        char args[LINE_SIZE];
+        switch(type) {
+        case THREAD_DISPATCH:
+            if(running[cpu].valid)
+                slice(cpu, running[cpu].thread, running[cpu].since, now);
+            running[cpu].valid = true;
+            running[cpu].thread = b;
+            running[cpu].since = now;
+            break;
+        case IRQ_ENTRY:
+        case IRQ_EXIT:
+            snprintf(name, LINE_SIZE, "IRQ %lu", a);
+            event(name, (type == IRQ_ENTRY) ? 'B' : 'E', cpu, IRQ_LANE, now);
+            break;
+        case SYSCALL_ENTRY:
+        case SYSCALL_EXIT:
+            snprintf(name, LINE_SIZE, "syscall %lu.%lu", a, b);
+            snprintf(args, LINE_SIZE, "\"entity\":%lu,\"method\":%lu", a, b);
+            event(name, (type == SYSCALL_ENTRY) ? 'B' : 'E', cpu, thread, now, args);
+            break;
+        case ALARM_HANDLER:
+            snprintf(args, LINE_SIZE, "\"alarm\":\"0x%lx\",\"tick\":%lu", a, b);
+            event("alarm", 'i', cpu, IRQ_LANE, now, args);
+            break;
+        case MUTEX_CONTENTION:
+            snprintf(args, LINE_SIZE, "\"mutex\":\"0x%lx\"", a);
+            event("mutex contention", 'i', cpu, thread, now, args);
+            break;
+        default:
+            fprintf(stderr, "Warning: unknown event %u in record %u, ignored!\n", type, records);
+        }
+    }
+
+    // Close the threads still running when the trace was dumped
+    for(unsigned int i = 0; i < MAX_CPUS; i++)
+        if(running[i].valid)
+            slice(i, running[i].thread, running[i].since, now);
+
+    fprintf(out, "\n]}\n");
+
+    if(records != count)
+        fprintf(stderr, "Warning: %u records announced, %u decoded!\n", count, records);
+
+    return 0;
+}
+
+// Converts a time stamp to microseconds since the first record, unwrapping 32-bit time stamp counters. Records of
+// different CPUs are not strictly ordered, so only a step back of more than half the counter range is taken as a wrap,
+// and a step forward of as much is taken as a record stamped before the last wrap
+double timestamp(unsigned long long time)
+{
+    if(first) {
+        first = false;
+        origin = last = time;
+    }
+
+    unsigned long long t = time;
+    if(time < WRAP_32) {
+        t += wraps;
+        if((t < last) && (last - t > WRAP_32 / 2)) {
+            wraps += WRAP_32;
+            t += WRAP_32;
+        } else if((t > last) && (t - last > WRAP_32 / 2) && (wraps >= WRAP_32))
+            return (t - WRAP_32 - origin) * 1000000.0 / frequency;
+    }
+    last = t;
+
+    return (last - origin) * 1000000.0 / frequency;
+}
+
+void event(const char * name, char ph, unsigned int cpu, unsigned long tid, double ts, const char * args)
+{
+    static bool separator = false;
+
+    fprintf(out, "%s{\"name\":\"%s\",\"ph\":\"%c\",\"pid\":%u,\"tid\":%lu,\"ts\":%.3f", separator ? ",\n" : "", name, ph, cpu, tid, ts);
+    if(ph == 'i')
+        fprintf(out, ",\"s\":\"t\"");
+    if(args)
+        fprintf(out, ",\"args\":{%s}", args);
+    fprintf(out, "}");
+
+    separator = true;
+}
+
+void slice(unsigned int cpu, unsigned long tid, double begin, double end)
+{
+    fprintf(out, ",\n{\"name\":\"running\",\"ph\":\"X\",\"pid\":%u,\"tid\":%lu,\"ts\":%.3f,\"dur\":%.3f}", cpu, tid, begin, end - begin);
+}